@@ -1,11 +1,23 @@
 #include <qt6purchasing/abstractproduct.h>
 #include <qt6purchasing/abstractstorebackend.h>
+#include <qt6purchasing/storetracer.h>
 
 AbstractProduct::AbstractProduct(QObject * parent) : QObject(parent)
 {
     connect(this, &AbstractProduct::identifierChanged, this, &AbstractProduct::updateIsReadyForRegister);
     connect(this, &AbstractProduct::productTypeChanged, this, &AbstractProduct::updateIsReadyForRegister);
     connect(this, &AbstractProduct::isReadyForRegisterChanged, this, &AbstractProduct::registerInStore);
+
+    // Deprecated per-property notifications, kept for one release
+    connect(this, &AbstractProduct::storeDataChanged, this, &AbstractProduct::titleChanged);
+    connect(this, &AbstractProduct::storeDataChanged, this, &AbstractProduct::descriptionChanged);
+    connect(this, &AbstractProduct::storeDataChanged, this, &AbstractProduct::priceChanged);
+}
+
+AbstractProduct::~AbstractProduct()
+{
+    if (_store)
+        _store->releaseProduct(this);
 }
 
 AbstractStoreBackend * AbstractProduct::findStoreBackend() const
@@ -25,7 +37,13 @@ void AbstractProduct::setDescription(QString value)
         return;
 
     _description = value;
-    emit descriptionChanged();
+    updateCatalogEntry();
+    notify(&AbstractProduct::storeDataChanged);
+}
+
+QByteArray AbstractProduct::platformPayload() const
+{
+    return _store ? _store->_catalog.platformPayload(_catalogHandle) : QByteArray();
 }
 
 void AbstractProduct::setIdentifier(const QString &value)
@@ -34,6 +52,7 @@ void AbstractProduct::setIdentifier(const QString &value)
         return;
 
     _identifier = value;
+    updateCatalogEntry();
     emit identifierChanged();
 }
 
@@ -43,7 +62,8 @@ void AbstractProduct::setPrice(const QString &value)
         return;
 
     _price = value;
-    emit priceChanged();
+    updateCatalogEntry();
+    notify(&AbstractProduct::storeDataChanged);
 }
 
 void AbstractProduct::setProductType(ProductType type)
@@ -52,6 +72,7 @@ void AbstractProduct::setProductType(ProductType type)
         return;
 
     _productType = type;
+    updateCatalogEntry();
     emit productTypeChanged();
 }
 
@@ -61,7 +82,17 @@ void AbstractProduct::setTitle(const QString &value)
         return;
 
     _title = value;
-    emit titleChanged();
+    updateCatalogEntry();
+    notify(&AbstractProduct::storeDataChanged);
+}
+
+void AbstractProduct::setFinalizePolicy(FinalizePolicy policy)
+{
+    if (_finalizePolicy == policy)
+        return;
+
+    _finalizePolicy = policy;
+    emit finalizePolicyChanged();
 }
 
 void AbstractProduct::setStatus(ProductStatus status)
@@ -70,8 +101,9 @@ void AbstractProduct::setStatus(ProductStatus status)
         return;
 
     _status = status;
-    qDebug() << "Product" << _identifier << _status;
-    emit statusChanged();
+    qCDebug(lcStore) << "Product" << _identifier << _status;
+    updateCatalogEntry();
+    notify(&AbstractProduct::statusChanged);
 }
 
 void AbstractProduct::setMicrosoftStoreId(const QString &value)
@@ -80,34 +112,48 @@ void AbstractProduct::setMicrosoftStoreId(const QString &value)
         return;
 
     _microsoftStoreId = value;
+    updateCatalogEntry();
     emit microsoftStoreIdChanged();
 }
 
-void AbstractProduct::registerInStore()
+void AbstractProduct::applyStoreData(const ProductStoreData &data, ProductStatus status)
 {
-    auto * store = findStoreBackend();
-    if (!store) {
-        qCritical() << "Product not child of a store backend!";
+    const bool dataDiffers = storeData() != data;
+    const bool statusDiffers = _status != status;
+    if (!dataDiffers && !statusDiffers)
         return;
-    }
 
-    if (!store->isConnected()) {
-        qDebug() << "No connection to store - will register when connected";
-        return;
+    _title = data.title;
+    _description = data.description;
+    _price = data.price;
+    _priceMicros = data.priceMicros;
+    _currencyCode = data.currencyCode;
+    _status = status;
+    updateCatalogEntry();
+
+    // Data first, so status handlers already see the new values
+    if (dataDiffers)
+        notify(&AbstractProduct::storeDataChanged);
+    if (statusDiffers) {
+        qCDebug(lcStore) << "Product" << _identifier << _status;
+        notify(&AbstractProduct::statusChanged);
     }
+}
 
-    if (_identifier.isEmpty()) {
-        qDebug() << "Product has no id - skipping registration";
+void AbstractProduct::registerInStore()
+{
+    auto * store = findStoreBackend();
+    if (!store) {
+        qCCritical(lcStore) << "Product not child of a store backend!";
         return;
     }
 
-    if (_status == PendingRegistration || _status == Registered) {
-        qDebug() << "Product" << _identifier << "already registered or pending";
+    if (store != _store) {
+        qCDebug(lcStore) << "Product not yet added to store - will register when added";
         return;
     }
 
-    setStatus(AbstractProduct::PendingRegistration);
-    store->registerProduct(this);
+    store->registerCatalogProduct(_catalogHandle);
 }
 
 void AbstractProduct::updateIsReadyForRegister()
@@ -121,28 +167,54 @@ void AbstractProduct::updateIsReadyForRegister()
     emit isReadyForRegisterChanged();
 }
 
+void AbstractProduct::notify(void (AbstractProduct::*signal)())
+{
+    // Store-driven notifications go through the store, which may coalesce them
+    if (_store)
+        _store->_notifications.notify(this, signal);
+    else
+        emit(this->*signal)();
+}
+
+void AbstractProduct::updateCatalogEntry()
+{
+    if (_store)
+        _store->updateCatalogEntry(this);
+}
+
 void AbstractProduct::purchase()
 {
     auto * store = findStoreBackend();
     if (!store) {
-        qCritical() << "Product not child of a store backend!";
+        qCCritical(lcStore) << "Product not child of a store backend!";
         return;
     }
 
-    if (!store->isConnected()) {
-        qWarning() << "Cannot purchase - store not connected";
+    if (_identifier.isEmpty()) {
+        qCWarning(lcStore) << "Cannot purchase - product has no identifier";
         return;
     }
 
-    if (_identifier.isEmpty()) {
-        qWarning() << "Cannot purchase - product has no identifier";
+    AbstractStoreBackend::PendingIntent intent;
+    intent.productId = _identifier;
+    if (store->deferIntent(intent))
+        return;
+
+    if (!store->isConnected()) {
+        qCWarning(lcStore) << "Cannot purchase - store not connected";
         return;
     }
 
     if (_status != AbstractProduct::Registered) {
-        qWarning() << "Cannot purchase unregistered product:" << _identifier;
+        qCWarning(lcStore) << "Cannot purchase unregistered product:" << _identifier;
+        return;
+    }
+
+    if (store->_warmRows.contains(_catalogHandle)) {
+        qCWarning(lcStore) << "Cannot purchase - product" << _identifier << "not yet confirmed by the store";
         return;
     }
 
-    store->purchaseProduct(this);
+    StoreTracer::beginAsync("purchase", _identifier);
+    store->requestPurchase(this);
 }
@@ -1,60 +1,165 @@
 #include <qt6purchasing/abstractstorebackend.h>
 #include <qt6purchasing/abstractproduct.h>
+#include <qt6purchasing/storetracer.h>
 
 #include <QTimer>
 
+#include <iterator>
+#include <limits>
+#include <utility>
+
+// Debug output is only formatted when enabled, e.g. QT_LOGGING_RULES="qt6purchasing.store.debug=false"
+// leaves routing free of logging allocations
+Q_LOGGING_CATEGORY(lcStore, "qt6purchasing.store")
+
 AbstractStoreBackend::AbstractStoreBackend(QObject * parent) : QObject(parent)
 {
-    qDebug() << "Creating store backend";
+    qCDebug(lcStore) << "Creating store backend";
+    _startupClock.start();
+    _milestones.constructedAt = _startupClock.msecsSinceReference();
+
+    _snapshotTimer.setSingleShot(true);
+    _snapshotTimer.setInterval(1000);
+    connect(&_snapshotTimer, &QTimer::timeout, this, &AbstractStoreBackend::saveSnapshot);
+
+    _refreshTimer.setSingleShot(true);
+    connect(&_refreshTimer, &QTimer::timeout, this, &AbstractStoreBackend::refreshStaleProducts);
+
+    _intentTimer.setSingleShot(true);
+    connect(&_intentTimer, &QTimer::timeout, this, &AbstractStoreBackend::runPendingIntents);
+
+    _startup.addStep("connect", {}, nullptr);
+    _startup.addStep("register", {"connect"}, [this]() {
+        registerCatalog();
+        scheduleRegistrationCheck();
+    });
+    _startup.addStep("restore", {"connect"}, [this]() {
+        // Without a startup restore there is no InitialRestoreComplete milestone to record
+        if (!_restoreOnConnect)
+            _startup.complete("restore");
+        else if (!isRestoringPurchases())
+            restorePurchases();
+    });
+    _startup.start();
 
     connect(this, &AbstractStoreBackend::connectedChanged, this, [this]() {
         if (isConnected()) {
-            qDebug() << "Connected to store";
-            qDebug() << "Found" << _products.size() << "product(s) awaiting registration";
-            for (AbstractProduct * product : _products) {
-                if (product->isReadyForRegister())
-                    product->registerInStore();
-            }
+            qCDebug(lcStore) << "Connected to store";
+            const bool reconnected = _milestones.isReached(StartupMilestones::Connected);
+            recordMilestone(StartupMilestones::Connected);
+            // Registration and the restore run again on every connection
+            _startup.complete("connect");
+            // Prices may have changed while the store was unreachable
+            if (reconnected)
+                refreshStaleProducts();
+            runPendingIntents();
         } else {
-            qDebug() << "Disconnected from store";
+            qCDebug(lcStore) << "Disconnected from store";
+            _lastRestore.invalidate();
+            // Requests in flight are lost with the connection; pending rows are registered, stale rows
+            // refreshed and warm rows confirmed on reconnecting
+            _refreshing.clear();
+            _warmRegistering.clear();
+            _refreshTimer.stop();
+            for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+                if (_catalog.status(handle) == AbstractProduct::PendingRegistration)
+                    setProductStatus(handle, AbstractProduct::Uninitialized);
+            }
+
+            // Not ready again until the startup steps have run on the next connection
+            const bool wasReady = isReady();
+            _startup.restart();
+            if (wasReady)
+                emit readyChanged();
         }
     });
 
+    // Unfiltered results are the whole product list
+    connect(this, &AbstractStoreBackend::productsChanged, this, [this]() {
+        if (ProductSearchIndex::tokenize(_searchQuery).isEmpty())
+            _notifications.notify(this, &AbstractStoreBackend::searchResultsChanged);
+    });
+
     connect(this, &AbstractStoreBackend::productRegistered, this, [](AbstractProduct * product) {
-        qDebug() << "Product registered:" << product->identifier();
+        qCDebug(lcStore) << "Product registered:" << product->identifier();
     });
 
-    connect(this, &AbstractStoreBackend::purchaseSucceeded, this, [this](Transaction transaction) {
-        qDebug() << "purchaseSucceeded:" << transaction.orderId;
+    connect(this, &AbstractStoreBackend::purchaseSucceeded, this, [this](const Transaction &transaction) {
+        qCDebug(lcStore) << "purchaseSucceeded:" << transaction.orderId;
+        StoreTraceSpan span("route purchaseSucceeded", transaction.orderId);
+        StoreTracer::endAsync("purchase", transaction.productId);
+        recordTransaction(TransactionRecord::Purchased, transaction.productId, transaction.orderId);
 
-        AbstractProduct * ap = product(transaction.productId);
-        if (ap) {
-            emit ap->purchaseSucceeded(transaction);
-        } else {
-            qCritical() << "Failed to map successful purchase to a product!";
+        // A cached restore result no longer reflects what is owned
+        _lastRestore.invalidate();
+
+        // Bought in this session, so not new to the next incremental restore
+        const ProductCatalog::Handle purchased = _catalog.handle(transaction.productId);
+        if (_incrementalRestore && purchased >= 0 && _catalog.productType(purchased) == AbstractProduct::Unlockable
+            && !_ownedProducts.contains(transaction.productId)) {
+            _ownedProducts.insert(transaction.productId);
+            emit ownedProductsChanged();
         }
+
+        if (_policyOwnedOrders.contains(transaction.key())) {
+            qCDebug(lcStore) << "Transaction" << transaction.orderId << "is already being finalized - not redelivering";
+            return;
+        }
+
+        // Held back from the product until the verifier reports a verdict
+        if (_verifier) {
+            StoreTracer::beginAsync("verify", transaction.key());
+            _verifying.append(transaction);
+            _verifier->verify(transaction);
+        } else
+            deliverPurchase(transaction);
     });
 
-    connect(this, &AbstractStoreBackend::purchasePending, this, [this](Transaction transaction) {
-        qDebug() << "purchasePending:" << transaction.orderId;
+    connect(this, &AbstractStoreBackend::purchasePending, this, [this](const Transaction &transaction) {
+        qCDebug(lcStore) << "purchasePending:" << transaction.orderId;
+        StoreTraceSpan span("route purchasePending", transaction.orderId);
+        StoreTracer::endAsync("purchase", transaction.productId);
+        recordTransaction(TransactionRecord::Pending, transaction.productId, transaction.orderId);
+
+        const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+        if (handle < 0) {
+            qCCritical(lcStore) << "Failed to map pending purchase to a product!";
+            return;
+        }
 
-        AbstractProduct * ap = product(transaction.productId);
-        if (ap) {
+        // Without a facade nobody can be listening on the product
+        if (AbstractProduct * ap = _catalog.facade(handle)) {
+            StoreTraceSpan handlers("product purchasePending", transaction.orderId);
             emit ap->purchasePending(transaction);
-        } else {
-            qCritical() << "Failed to map pending purchase to a product!";
         }
     });
 
-    connect(this, &AbstractStoreBackend::purchaseRestored, this, [this](Transaction transaction) {
-        qDebug() << "purchaseRestored:" << transaction.orderId;
+    connect(this, &AbstractStoreBackend::purchaseRestored, this, [this](const Transaction &transaction) {
+        qCDebug(lcStore) << "purchaseRestored:" << transaction.orderId;
+        StoreTraceSpan span("route purchaseRestored", transaction.orderId);
+        recordTransaction(TransactionRecord::Restored, transaction.productId, transaction.orderId);
+
+        if (_policyOwnedOrders.contains(transaction.key())) {
+            qCDebug(lcStore) << "Transaction" << transaction.orderId << "is already being finalized - not redelivering";
+            return;
+        }
 
-        AbstractProduct * ap = product(transaction.productId);
-        if (ap) {
+        const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+        if (handle < 0) {
+            qCCritical(lcStore) << "Failed to map restored purchase to a product!";
+            return;
+        }
+
+        // Without a facade nobody can be listening on the product; in incremental mode
+        // nothing has changed for an unlockable already known to be owned
+        const bool changed = noteRestoredOwnership(handle, transaction);
+        AbstractProduct * ap = _catalog.facade(handle);
+        if (ap && changed) {
+            StoreTraceSpan handlers("product purchaseRestored", transaction.orderId);
             emit ap->purchaseRestored(transaction);
-        } else {
-            qCritical() << "Failed to map restored purchase to a product!";
         }
+
+        applyFinalizePolicy(handle, transaction);
     });
 
     connect(
@@ -62,44 +167,70 @@ AbstractStoreBackend::AbstractStoreBackend(QObject * parent) : QObject(parent)
         &AbstractStoreBackend::purchaseFailed,
         this,
         [this](const QString &productId, int error, int platformCode, const QString &message) {
-            qDebug() << "purchaseFailed:" << "productId=" << productId << "error=" << error
-                     << "platformCode=" << platformCode << "message=" << message;
+            qCDebug(lcStore) << "purchaseFailed:" << "productId=" << productId << "error=" << error
+                             << "platformCode=" << platformCode << "message=" << message;
+            StoreTraceSpan span("route purchaseFailed", productId);
+            StoreTracer::endAsync("purchase", productId);
+            recordTransaction(TransactionRecord::Failed, productId, QString(), error, message);
 
             // Route to the appropriate product
-            AbstractProduct * ap = product(productId);
-            if (ap) {
-                emit ap->purchaseFailed(error, platformCode, message);
-            } else {
-                qWarning() << "Failed to find product for purchase failure:" << productId;
+            const ProductCatalog::Handle handle = _catalog.handle(productId);
+            if (handle < 0) {
+                qCWarning(lcStore) << "Failed to find product for purchase failure:" << productId;
+                return;
             }
+
+            if (AbstractProduct * ap = _catalog.facade(handle))
+                emit ap->purchaseFailed(error, platformCode, message);
         }
     );
 
-    connect(this, &AbstractStoreBackend::consumePurchaseSucceeded, this, [this](Transaction transaction) {
-        qDebug() << "consumePurchaseSucceeded:" << transaction.orderId;
+    connect(this, &AbstractStoreBackend::consumePurchaseSucceeded, this, [this](const Transaction &transaction) {
+        qCDebug(lcStore) << "consumePurchaseSucceeded:" << transaction.orderId;
+        StoreTraceSpan span("route consumePurchaseSucceeded", transaction.orderId);
+        StoreTracer::endAsync("finalize", transaction.key());
+        finishFinalization(transaction, true);
+        recordTransaction(TransactionRecord::Consumed, transaction.productId, transaction.orderId);
 
-        AbstractProduct * ap = product(transaction.productId);
-        if (ap) {
-            emit ap->consumePurchaseSucceeded(transaction);
-        } else {
-            qCritical() << "Failed to map consumed purchase to a product!";
+        const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+        if (handle < 0) {
+            qCCritical(lcStore) << "Failed to map consumed purchase to a product!";
+            return;
         }
+
+        // Without a facade nobody can be listening on the product
+        if (AbstractProduct * ap = _catalog.facade(handle))
+            emit ap->consumePurchaseSucceeded(transaction);
     });
 
-    connect(this, &AbstractStoreBackend::consumePurchaseFailed, this, [this](Transaction transaction) {
-        qDebug() << "consumePurchaseFailed:" << transaction.orderId;
+    connect(this, &AbstractStoreBackend::consumePurchaseFailed, this, [this](const Transaction &transaction) {
+        qCDebug(lcStore) << "consumePurchaseFailed:" << transaction.orderId;
+        StoreTraceSpan span("route consumePurchaseFailed", transaction.orderId);
+        StoreTracer::endAsync("finalize", transaction.key());
+        finishFinalization(transaction, false);
+        recordTransaction(TransactionRecord::ConsumeFailed, transaction.productId, transaction.orderId);
 
-        AbstractProduct * ap = product(transaction.productId);
-        if (ap) {
-            emit ap->consumePurchaseFailed(transaction);
-        } else {
-            qCritical() << "Failed to map failed consumption to a product!";
+        const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+        if (handle < 0) {
+            qCCritical(lcStore) << "Failed to map failed consumption to a product!";
+            return;
         }
+
+        // Without a facade nobody can be listening on the product
+        if (AbstractProduct * ap = _catalog.facade(handle))
+            emit ap->consumePurchaseFailed(transaction);
     });
 
     connect(this, &AbstractStoreBackend::restorePurchasesSucceeded, this, [this](int count) {
-        qDebug() << "restorePurchasesSucceeded: count=" << count;
-        setIsRestoringPurchases(false);
+        qCDebug(lcStore) << "restorePurchasesSucceeded: count=" << count;
+        // The backend is still holding the restored transactions; completing now would report every
+        // owned product as revoked, then as added again once they are processed
+        if (!_processingEnabled && isRestoringPurchases()) {
+            qCDebug(lcStore) << "Restore completion held until queued transactions are processed";
+            _heldRestoreCount = count;
+            return;
+        }
+        completeRestore(count);
     });
 
     connect(
@@ -107,46 +238,1166 @@ AbstractStoreBackend::AbstractStoreBackend(QObject * parent) : QObject(parent)
         &AbstractStoreBackend::restorePurchasesFailed,
         this,
         [this](int error, int platformCode, const QString &message) {
-            qDebug() << "restorePurchasesFailed:" << "error=" << error << "platformCode=" << platformCode
-                     << "message=" << message;
-            // A Busy failure is a duplicate request rejected while a restore is already
-            // running; it must not clear the flag for the restore still in flight.
+            qCDebug(lcStore) << "restorePurchasesFailed:" << "error=" << error << "platformCode=" << platformCode
+                             << "message=" << message;
+            // A Busy failure (from a backend; the store itself joins duplicate requests) must
+            // not clear the flag for the restore still in flight.
             if (error == static_cast<int>(PurchaseError::Busy))
                 return;
+            StoreTracer::endAsync("restore", "restore");
+            finishIncrementalRestore(false);
             setIsRestoringPurchases(false);
+            completeStartupRestore();
         }
     );
 }
 
-QQmlListProperty<AbstractProduct> AbstractStoreBackend::productsQml()
+AbstractStoreBackend::~AbstractStoreBackend()
 {
-    return QQmlListProperty<AbstractProduct>(this, nullptr, &appendProduct, &productCount, &productAt, &clearProducts);
+    if (!_snapshotPath.isEmpty())
+        saveSnapshot();
+
+    // Facades are usually our children and are destroyed after the catalog; detach them first
+    detachProducts();
+}
+
+QList<AbstractProduct *> AbstractStoreBackend::products()
+{
+    QList<AbstractProduct *> result;
+    result.reserve(_catalog.size());
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle)
+        result.append(productForHandle(handle));
+    return result;
+}
+
+QList<AbstractProduct *> AbstractStoreBackend::searchProducts(const QString &query)
+{
+    const QList<ProductCatalog::Handle> handles = _searchIndex.search(query);
+    QList<AbstractProduct *> result;
+    result.reserve(handles.size());
+    for (const ProductCatalog::Handle handle : handles)
+        result.append(productForHandle(handle));
+    return result;
+}
+
+void AbstractStoreBackend::setSearchQuery(const QString &searchQuery)
+{
+    if (_searchQuery == searchQuery)
+        return;
+
+    _searchQuery = searchQuery;
+    emit searchQueryChanged();
+    emit searchResultsChanged();
+}
+
+QList<AbstractProduct *> AbstractStoreBackend::searchResults()
+{
+    if (ProductSearchIndex::tokenize(_searchQuery).isEmpty())
+        return products();
+    return searchProducts(_searchQuery);
 }
 
 AbstractProduct * AbstractStoreBackend::product(const QString &identifier)
 {
-    for (AbstractProduct * ap : _products) {
-        if (ap->identifier() == identifier)
-            return ap;
+    return productForHandle(_catalog.handle(identifier));
+}
+
+AbstractProduct * AbstractStoreBackend::productForHandle(ProductCatalog::Handle handle)
+{
+    if (!_catalog.contains(handle))
+        return nullptr;
+
+    if (AbstractProduct * facade = _catalog.facade(handle))
+        return facade;
+
+    AbstractProduct * product = createProduct(handle);
+    product->setParent(this);
+
+    // Populate directly from the row: nothing has changed, so no signals and no re-registration
+    product->_identifier = _catalog.identifier(handle);
+    product->_productType = _catalog.productType(handle);
+    product->_microsoftStoreId = _catalog.microsoftStoreId(handle);
+    product->_status = _catalog.status(handle);
+    product->_title = _catalog.title(handle);
+    product->_description = _catalog.description(handle);
+    product->_price = _catalog.price(handle);
+    product->_priceMicros = _catalog.priceMicros(handle);
+    product->_currencyCode = _catalog.currencyCode(handle);
+    product->_isReadyForRegister = product->_productType != AbstractProduct::None && !product->_identifier.isEmpty();
+
+    bindProduct(handle, product);
+    return product;
+}
+
+qsizetype AbstractStoreBackend::addProduct(
+    const QString &identifier, AbstractProduct::ProductType type, const QString &microsoftStoreId
+)
+{
+    const ProductCatalog::Handle handle = _catalog.insert(identifier, type);
+    _catalog.setMicrosoftStoreId(handle, microsoftStoreId);
+    _notifications.notify(this, &AbstractStoreBackend::productsChanged);
+
+    if (type != AbstractProduct::None)
+        registerCatalogProduct(handle);
+
+    return handle;
+}
+
+void AbstractStoreBackend::registerCatalog()
+{
+    qCDebug(lcStore) << "Found" << _catalog.size() << "product(s) awaiting registration";
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+        if (_catalog.productType(handle) != AbstractProduct::None)
+            registerCatalogProduct(handle);
+    }
+}
+
+void AbstractStoreBackend::scheduleRegistrationCheck()
+{
+    // Deferred so products declared alongside the store (e.g. in QML) are counted, and so a
+    // large catalog is scanned once per event loop iteration rather than once per product
+    if (_registrationCheckScheduled || !_startup.isRunning("register"))
+        return;
+    _registrationCheckScheduled = true;
+    QTimer::singleShot(0, this, &AbstractStoreBackend::checkRegistrationComplete);
+}
+
+void AbstractStoreBackend::checkRegistrationComplete()
+{
+    _registrationCheckScheduled = false;
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+        if (_catalog.status(handle) == AbstractProduct::PendingRegistration || _warmRows.contains(handle))
+            return;
     }
-    return nullptr;
+    recordMilestone(StartupMilestones::AllProductsRegistered);
+    _startup.complete("register");
+}
+
+void AbstractStoreBackend::completeStartupRestore()
+{
+    if (!_startup.isRunning("restore"))
+        return;
+    recordMilestone(StartupMilestones::InitialRestoreComplete);
+    _startup.complete("restore");
+}
+
+bool AbstractStoreBackend::noteRestoredOwnership(ProductCatalog::Handle handle, const Transaction &transaction)
+{
+    // Consumables are restored until consumed, so every report is news
+    if (!_incrementalRestore || _catalog.productType(handle) != AbstractProduct::Unlockable)
+        return true;
+
+    if (isRestoringPurchases())
+        _restoredOwned.insert(transaction.productId);
+
+    if (_ownedProducts.contains(transaction.productId)) {
+        qCDebug(lcStore) << "Restored" << transaction.productId << "is already owned - not redelivering";
+        return false;
+    }
+
+    _ownedProducts.insert(transaction.productId);
+    emit ownedProductsChanged();
+    emit restoredPurchaseAdded(transaction);
+    return true;
+}
+
+void AbstractStoreBackend::completeRestore(int count)
+{
+    // Not restoring when a cached result is reported again
+    if (isRestoringPurchases()) {
+        StoreTracer::endAsync("restore", "restore");
+        finishIncrementalRestore(true);
+        _lastRestoreCount = count;
+        _lastRestore.start();
+    }
+    setIsRestoringPurchases(false);
+    completeStartupRestore();
+}
+
+void AbstractStoreBackend::finishQueuedTransactions()
+{
+    recordMilestone(StartupMilestones::QueuedTransactionsDrained);
+    if (_heldRestoreCount >= 0)
+        completeRestore(std::exchange(_heldRestoreCount, -1));
+}
+
+void AbstractStoreBackend::finishIncrementalRestore(bool succeeded)
+{
+    const QSet<QString> restored = std::exchange(_restoredOwned, {});
+    // A failed restore says nothing about what is still owned
+    if (!_incrementalRestore || !succeeded)
+        return;
+
+    const QSet<QString> revoked = QSet<QString>(_ownedProducts).subtract(restored);
+    if (revoked.isEmpty())
+        return;
+
+    _ownedProducts = restored;
+    emit ownedProductsChanged();
+    for (const QString &productId : revoked) {
+        qCDebug(lcStore) << "Restore no longer reports" << productId << "- revoked";
+        emit restoredPurchaseRevoked(productId);
+
+        const ProductCatalog::Handle handle = _catalog.handle(productId);
+        if (AbstractProduct * ap = handle >= 0 ? _catalog.facade(handle) : nullptr)
+            emit ap->purchaseRevoked();
+    }
+}
+
+void AbstractStoreBackend::setRestoreResultTtl(int restoreResultTtl)
+{
+    if (_restoreResultTtl == restoreResultTtl)
+        return;
+    _restoreResultTtl = restoreResultTtl;
+    emit restoreResultTtlChanged();
+}
+
+void AbstractStoreBackend::setIncrementalRestore(bool incrementalRestore)
+{
+    if (_incrementalRestore == incrementalRestore)
+        return;
+    _incrementalRestore = incrementalRestore;
+    emit incrementalRestoreChanged();
+}
+
+void AbstractStoreBackend::setOwnedProducts(const QStringList &ownedProducts)
+{
+    const QSet<QString> owned(ownedProducts.cbegin(), ownedProducts.cend());
+    if (_ownedProducts == owned)
+        return;
+    _ownedProducts = owned;
+    emit ownedProductsChanged();
+}
+
+void AbstractStoreBackend::recordMilestone(StartupMilestones::Milestone milestone)
+{
+    if (_milestones.isReached(milestone))
+        return;
+
+    _milestones.elapsed[milestone] = _startupClock.elapsed();
+    _notifications.notify(this, &AbstractStoreBackend::startupMilestonesChanged);
+}
+
+void AbstractStoreBackend::logStartupSummary()
+{
+    // Once, when the store first becomes ready; an empty catalog or a failed registration
+    // leaves milestones unreached, and those are listed rather than holding the summary back
+    if (std::exchange(_startupSummaryLogged, true))
+        return;
+
+    static const char * const names[] = {
+        "connected", "first product", "all products", "processing enabled", "restore", "queue drained"
+    };
+    static_assert(std::size(names) == StartupMilestones::MilestoneCount);
+
+    QStringList reached;
+    QStringList missing;
+    for (int index = 0; index < StartupMilestones::MilestoneCount; ++index) {
+        const auto milestone = static_cast<StartupMilestones::Milestone>(index);
+        if (_milestones.isReached(milestone))
+            reached.append(QString("%1 %2").arg(names[index]).arg(_milestones.at(milestone)));
+        else
+            missing.append(names[index]);
+    }
+    qCInfo(lcStore).noquote() << "Startup milestones (ms):" << reached.join(", ")
+                              << (missing.isEmpty() ? QString() : "- not reached: " + missing.join(", "));
+}
+
+void AbstractStoreBackend::registerCatalogProduct(ProductCatalog::Handle handle)
+{
+    applySnapshot(handle);
+
+    if (!isConnected()) {
+        qCDebug(lcStore) << "No connection to store - will register when connected";
+        return;
+    }
+
+    const QString identifier = _catalog.identifier(handle);
+    if (identifier.isEmpty()) {
+        qCDebug(lcStore) << "Product has no id - skipping registration";
+        return;
+    }
+
+    const AbstractProduct::ProductStatus status = _catalog.status(handle);
+    // Products filled from the snapshot keep their data on screen while the store confirms them
+    if (_warmRows.contains(handle)) {
+        if (_warmRegistering.contains(handle)) {
+            qCDebug(lcStore) << "Product" << identifier << "is already being confirmed";
+            return;
+        }
+        _warmRegistering.insert(handle);
+        submitRequest(
+            RegisterRequest,
+            [this, identifier]() { registerProduct(identifier); },
+            [this, identifier]() {
+                // Stops waiting for a confirmation that will not come; the snapshot data stays
+                const ProductCatalog::Handle shed = _catalog.handle(identifier);
+                if (shed < 0)
+                    return;
+                _warmRegistering.remove(shed);
+                _warmRows.remove(shed);
+                scheduleRegistrationCheck();
+            }
+        );
+        return;
+    }
+
+    if (status == AbstractProduct::PendingRegistration || status == AbstractProduct::Registered) {
+        qCDebug(lcStore) << "Product" << identifier << "already registered or pending";
+        return;
+    }
+
+    setProductStatus(handle, AbstractProduct::PendingRegistration);
+    submitRequest(
+        RegisterRequest,
+        [this, identifier]() { registerProduct(identifier); },
+        [this, identifier]() {
+            const ProductCatalog::Handle shed = _catalog.handle(identifier);
+            if (shed >= 0)
+                setProductStatus(shed, AbstractProduct::Unknown);
+        }
+    );
+}
+
+void AbstractStoreBackend::submitRequest(RequestKind kind, RateLimiter::Call call, RateLimiter::Call shed)
+{
+    _requestLimiter.submit(kind, std::move(call), [kind, shed = std::move(shed)]() {
+        qCWarning(lcStore) << "Too many" << kind << "calls waiting - shedding one";
+        if (shed)
+            shed();
+    });
+}
+
+void AbstractStoreBackend::requestPurchase(AbstractProduct * product)
+{
+    const QString identifier = product->identifier();
+    submitRequest(
+        PurchaseRequest,
+        [this, product = QPointer<AbstractProduct>(product)]() {
+            if (product)
+                purchaseProduct(product);
+        },
+        [this, identifier]() {
+            emit purchaseFailed(identifier, static_cast<int>(PurchaseError::Busy), 0, "Too many purchase requests");
+        }
+    );
+}
+
+void AbstractStoreBackend::setRequestRateLimit(RequestKind kind, double perSecond, int burst)
+{
+    _requestLimiter.setLimit(kind, perSecond, burst);
+}
+
+QVariantMap AbstractStoreBackend::requestCounters(RequestKind kind) const
+{
+    const RateLimiter::Counters counters = _requestLimiter.counters(kind);
+    QVariantMap result;
+    result["admitted"] = counters.admitted;
+    result["delayed"] = counters.delayed;
+    result["shed"] = counters.shed;
+    result["queued"] = counters.queued;
+    return result;
+}
+
+void AbstractStoreBackend::setMaxQueuedRequests(int maxQueuedRequests)
+{
+    if (_requestLimiter.maxQueued() == maxQueuedRequests)
+        return;
+    _requestLimiter.setMaxQueued(maxQueuedRequests);
+    emit maxQueuedRequestsChanged();
+}
+
+void AbstractStoreBackend::adoptProduct(AbstractProduct * product)
+{
+    const ProductCatalog::Handle handle = _catalog.insert(product->identifier(), product->productType());
+    bindProduct(handle, product);
+    _notifications.notify(this, &AbstractStoreBackend::productsChanged);
+
+    if (product->isReadyForRegister())
+        product->registerInStore();
+}
+
+void AbstractStoreBackend::bindProduct(ProductCatalog::Handle handle, AbstractProduct * product)
+{
+    product->_store = this;
+    product->_catalogHandle = handle;
+    _catalog.setFacade(handle, product);
+    updateCatalogEntry(product);
+}
+
+void AbstractStoreBackend::updateCatalogEntry(const AbstractProduct * product)
+{
+    const ProductCatalog::Handle handle = product->_catalogHandle;
+    _catalog.setIdentifier(handle, product->identifier());
+    _catalog.setProductType(handle, product->productType());
+    _catalog.setMicrosoftStoreId(handle, product->microsoftStoreId());
+    _catalog.setStatus(handle, product->status());
+    _catalog.setStoreData(handle, product->storeData());
+}
+
+void AbstractStoreBackend::detachProducts()
+{
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+        if (AbstractProduct * facade = _catalog.facade(handle)) {
+            facade->_store = nullptr;
+            facade->_catalogHandle = -1;
+        }
+    }
+}
+
+void AbstractStoreBackend::releaseProduct(const AbstractProduct * product)
+{
+    // The row outlives its facade; a new one is created if the product is requested again
+    if (_catalog.contains(product->_catalogHandle) && _catalog.facade(product->_catalogHandle) == product)
+        _catalog.setFacade(product->_catalogHandle, nullptr);
+}
+
+void AbstractStoreBackend::dispatchStoreEvent(const StoreEvent &event)
+{
+    if (event.type == QueuedTransactionsDrainedEvent)
+        finishQueuedTransactions();
+    else
+        handleStoreEvent(event);
+}
+
+void AbstractStoreBackend::handleStoreEvent(const StoreEvent &event)
+{
+    qCWarning(lcStore) << "Store event" << event.type << "posted but not handled by this backend";
+}
+
+void AbstractStoreBackend::setProductStatus(ProductCatalog::Handle handle, AbstractProduct::ProductStatus status)
+{
+    // A failed refresh keeps the data already shown; it is tried again once that is stale again
+    if (_refreshing.remove(handle) && status == AbstractProduct::Unknown) {
+        qCDebug(lcStore) << "Refresh failed for" << _catalog.identifier(handle) << "- keeping its data";
+        _catalog.setRefreshedAt(handle, _startupClock.elapsed());
+        if (_maxMetadataAge > 0 && !_refreshTimer.isActive())
+            _refreshTimer.start(_maxMetadataAge);
+        return;
+    }
+
+    if (status != AbstractProduct::PendingRegistration) {
+        _warmRows.remove(handle);
+        _warmRegistering.remove(handle);
+    }
+    scheduleSnapshot();
+
+    if (AbstractProduct * facade = _catalog.facade(handle))
+        facade->setStatus(status);
+    else
+        _catalog.setStatus(handle, status);
+
+    if (status == AbstractProduct::Registered)
+        recordMilestone(StartupMilestones::FirstProductRegistered);
+
+    scheduleRegistrationCheck();
+    // A queued purchase may have been waiting for this product
+    if (!_pendingIntents.isEmpty())
+        runPendingIntents();
+}
+
+void AbstractStoreBackend::applyStoreData(
+    ProductCatalog::Handle handle, const ProductStoreData &data, AbstractProduct::ProductStatus status
+)
+{
+    _warmRows.remove(handle);
+    _warmRegistering.remove(handle);
+    _refreshing.remove(handle);
+    scheduleSnapshot();
+    writeStoreData(handle, data, status);
+
+    // A fresh row expires no sooner than anything the timer is already waiting for
+    _catalog.setRefreshedAt(handle, _startupClock.elapsed());
+    if (_maxMetadataAge > 0 && !_refreshTimer.isActive())
+        _refreshTimer.start(_maxMetadataAge);
+
+    if (status == AbstractProduct::Registered)
+        recordMilestone(StartupMilestones::FirstProductRegistered);
+    scheduleRegistrationCheck();
+    if (!_pendingIntents.isEmpty())
+        runPendingIntents();
+}
+
+void AbstractStoreBackend::writeStoreData(
+    ProductCatalog::Handle handle, const ProductStoreData &data, AbstractProduct::ProductStatus status
+)
+{
+    // Stores that only report a numeric price get it formatted here
+    ProductStoreData formatted = data;
+    if (formatted.price.isEmpty())
+        formatted.price = _priceFormatter.format(data.priceMicros, data.currencyCode);
+
+    const bool textChanged = _catalog.title(handle) != formatted.title
+                             || _catalog.description(handle) != formatted.description;
+
+    // Products only emit change signals for what actually differs, so an unchanged refresh is silent
+    if (AbstractProduct * facade = _catalog.facade(handle)) {
+        facade->applyStoreData(formatted, status);
+    } else {
+        _catalog.setStoreData(handle, formatted);
+        _catalog.setStatus(handle, status);
+    }
+
+    // Re-indexed in place, so a filtered list picks up renamed products
+    if (textChanged) {
+        _searchIndex.update(handle, formatted.title, formatted.description);
+        if (!ProductSearchIndex::tokenize(_searchQuery).isEmpty())
+            _notifications.notify(this, &AbstractStoreBackend::searchResultsChanged);
+    }
+}
+
+QString AbstractStoreBackend::formatPrice(qint64 priceMicros, const QString &currencyCode)
+{
+    return _priceFormatter.format(priceMicros, currencyCode);
+}
+
+void AbstractStoreBackend::setVerifier(TransactionVerifier * verifier)
+{
+    if (_verifier == verifier)
+        return;
+
+    if (_verifier)
+        disconnect(_verifier, nullptr, this, nullptr);
+
+    _verifier = verifier;
+    if (_verifier) {
+        connect(_verifier, &TransactionVerifier::verified, this, &AbstractStoreBackend::onTransactionVerified);
+        connect(_verifier, &QObject::destroyed, this, [this]() {
+            failVerifications();
+            emit verifierChanged();
+        });
+    }
+
+    // The previous verifier no longer reports here
+    failVerifications();
+    emit verifierChanged();
+}
+
+void AbstractStoreBackend::failVerifications()
+{
+    // Each verdict removes its transaction, so work from a copy
+    const QList<Transaction> verifying = _verifying;
+    for (const Transaction &transaction : verifying)
+        onTransactionVerified(transaction, TransactionVerifier::Error);
+}
+
+void AbstractStoreBackend::deliverPurchase(const Transaction &transaction)
+{
+    const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+    if (handle < 0) {
+        qCCritical(lcStore) << "Failed to map successful purchase to a product!";
+        return;
+    }
+
+    // Without a facade nobody can be listening on the product; the span includes QML handlers
+    if (AbstractProduct * ap = _catalog.facade(handle)) {
+        StoreTraceSpan handlers("product purchaseSucceeded", transaction.orderId);
+        emit ap->purchaseSucceeded(transaction);
+    }
+
+    applyFinalizePolicy(handle, transaction);
+}
+
+void AbstractStoreBackend::onTransactionVerified(const Transaction &transaction, TransactionVerifier::Verdict verdict)
+{
+    const QString key = transaction.key();
+    StoreTracer::endAsync("verify", key);
+    for (qsizetype i = 0; i < _verifying.size(); ++i) {
+        if (_verifying.at(i).key() == key) {
+            _verifying.removeAt(i);
+            break;
+        }
+    }
+
+    if (verdict == TransactionVerifier::Valid) {
+        deliverPurchase(transaction);
+        return;
+    }
+
+    qCWarning(lcStore) << "Purchase" << transaction.orderId << "failed verification:" << verdict;
+
+    // The transaction is left unfinalized so the app can retry or let the store refund it
+    emit purchaseVerificationFailed(transaction, verdict);
+
+    const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+    if (handle < 0)
+        return;
+
+    if (AbstractProduct * ap = _catalog.facade(handle)) {
+        const bool rejected = verdict == TransactionVerifier::Invalid;
+        emit ap->purchaseFailed(
+            static_cast<int>(rejected ? PurchaseError::PaymentInvalid : PurchaseError::NetworkError),
+            0,
+            rejected ? "Purchase rejected by verification server" : "Purchase could not be verified"
+        );
+    }
+}
+
+void AbstractStoreBackend::setHistoryPath(const QString &historyPath)
+{
+    if (_history.directory() == historyPath)
+        return;
+
+    if (historyPath.isEmpty())
+        _history.close();
+    else if (!_history.open(historyPath))
+        qCWarning(lcStore) << "Transaction history disabled: failed to open" << historyPath;
+
+    emit historyPathChanged();
+}
+
+void AbstractStoreBackend::setSnapshotPath(const QString &snapshotPath)
+{
+    if (_snapshotPath == snapshotPath)
+        return;
+
+    _snapshotPath = snapshotPath;
+    _snapshot.clear();
+
+    // Fill products declared so far; the rest are filled as they are registered
+    if (!_snapshotPath.isEmpty() && _snapshot.load(_snapshotPath)) {
+        for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle)
+            applySnapshot(handle);
+    }
+
+    emit snapshotPathChanged();
+}
+
+void AbstractStoreBackend::saveSnapshot()
+{
+    _snapshotTimer.stop();
+    if (_snapshotPath.isEmpty())
+        return;
+
+    if (!StoreSnapshot::save(_snapshotPath, _catalog))
+        qCWarning(lcStore) << "Failed to save store snapshot to" << _snapshotPath;
+}
+
+void AbstractStoreBackend::setMaxMetadataAge(int maxMetadataAge)
+{
+    maxMetadataAge = qMax(0, maxMetadataAge);
+    if (_maxMetadataAge == maxMetadataAge)
+        return;
+
+    _maxMetadataAge = maxMetadataAge;
+    emit maxMetadataAgeChanged();
+
+    if (_maxMetadataAge > 0)
+        refreshStaleProducts();
+    else
+        _refreshTimer.stop();
+}
+
+void AbstractStoreBackend::refreshStaleProducts()
+{
+    _refreshTimer.stop();
+    if (_maxMetadataAge <= 0 || !isConnected())
+        return;
+
+    // A few at a time, so a long catalog does not crowd out purchases at the rate limiter
+    const qint64 now = _startupClock.elapsed();
+    int batch = 0;
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+        if (_catalog.status(handle) != AbstractProduct::Registered || _warmRows.contains(handle)
+            || _refreshing.contains(handle) || now - _catalog.refreshedAt(handle) < _maxMetadataAge)
+            continue;
+
+        if (batch == RefreshBatchSize) {
+            _refreshTimer.start(RefreshBatchInterval);
+            return;
+        }
+        ++batch;
+
+        const QString identifier = _catalog.identifier(handle);
+        qCDebug(lcStore) << "Refreshing" << identifier << "- data is" << now - _catalog.refreshedAt(handle)
+                         << "ms old";
+        _refreshing.insert(handle);
+        submitRequest(
+            RegisterRequest,
+            [this, handle, identifier]() {
+                // Dropped if the connection went in the meantime
+                if (_refreshing.contains(handle))
+                    registerProduct(identifier);
+            },
+            [this, handle]() { _refreshing.remove(handle); }
+        );
+    }
+
+    scheduleRefresh();
+}
+
+void AbstractStoreBackend::scheduleRefresh()
+{
+    // Wake when the oldest row that is not already being refreshed goes stale
+    qint64 oldest = -1;
+    for (ProductCatalog::Handle handle = 0; handle < _catalog.size(); ++handle) {
+        if (_catalog.status(handle) != AbstractProduct::Registered || _warmRows.contains(handle)
+            || _refreshing.contains(handle))
+            continue;
+        const qint64 refreshedAt = _catalog.refreshedAt(handle);
+        if (oldest < 0 || refreshedAt < oldest)
+            oldest = refreshedAt;
+    }
+
+    if (oldest >= 0)
+        _refreshTimer.start(qMax<qint64>(0, oldest + _maxMetadataAge - _startupClock.elapsed()));
+}
+
+void AbstractStoreBackend::applySnapshot(ProductCatalog::Handle handle)
+{
+    if (_snapshot.isEmpty() || _catalog.status(handle) != AbstractProduct::Uninitialized)
+        return;
+
+    const StoreSnapshot::Product * cached = _snapshot.find(_catalog.identifier(handle));
+    if (!cached || cached->type != _catalog.productType(handle))
+        return;
+
+    if (_catalog.microsoftStoreId(handle).isEmpty())
+        _catalog.setMicrosoftStoreId(handle, cached->microsoftStoreId);
+    // Not reported by the store: no startup milestone, and no refresh time until the store confirms it
+    writeStoreData(handle, cached->data, AbstractProduct::Registered);
+    _warmRows.insert(handle);
+}
+
+void AbstractStoreBackend::scheduleSnapshot()
+{
+    // Checkpoint once a burst of registrations has settled
+    if (!_snapshotPath.isEmpty())
+        _snapshotTimer.start();
+}
+
+QList<TransactionRecord> AbstractStoreBackend::transactionHistory(
+    const QString &productId, const QDateTime &from, const QDateTime &to, int offset, int limit
+)
+{
+    return _history.query(
+        productId,
+        from.isValid() ? from.toMSecsSinceEpoch() : 0,
+        to.isValid() ? to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max(),
+        offset,
+        limit
+    );
+}
+
+void AbstractStoreBackend::recordTransaction(
+    TransactionRecord::Outcome outcome,
+    const QString &productId,
+    const QString &orderId,
+    int error,
+    const QString &message
+)
+{
+    if (!_history.isOpen())
+        return;
+
+    TransactionRecord record;
+    record.productId = productId;
+    record.orderId = orderId;
+    record.outcome = outcome;
+    record.error = error;
+    record.message = message;
+    _history.append(record);
 }
 
 void AbstractStoreBackend::restorePurchases()
 {
+    PendingIntent intent;
+    intent.kind = PendingIntent::Restore;
+    if (deferIntent(intent))
+        return;
+
+    // Every listener receives the result of the restore in flight
     if (isRestoringPurchases()) {
-        emit restorePurchasesFailed(static_cast<int>(PurchaseError::Busy), 0, "");
+        qCDebug(lcStore) << "Restore already in progress - joining it";
+        return;
+    }
+
+    if (_restoreResultTtl > 0 && _lastRestore.isValid() && !_lastRestore.hasExpired(_restoreResultTtl)) {
+        qCDebug(lcStore) << "Reusing restore result from" << _lastRestore.elapsed() << "ms ago";
+        const int count = _lastRestoreCount;
+        QMetaObject::invokeMethod(
+            this, [this, count]() { emit restorePurchasesSucceeded(count); }, Qt::QueuedConnection
+        );
         return;
     }
 
     setIsRestoringPurchases(true);
-    restorePurchasesImpl();
+    StoreTracer::beginAsync("restore", "restore");
+    submitRequest(RestoreRequest, [this]() { restorePurchasesImpl(); }, [this]() {
+        // Not Busy: that would leave the restore flag set
+        emit restorePurchasesFailed(
+            static_cast<int>(PurchaseError::ServiceUnavailable), 0, "Too many restore requests"
+        );
+    });
 }
 
 void AbstractStoreBackend::finalize(Transaction transaction)
 {
-    qDebug() << "Store: Finalizing transaction" << transaction.orderId;
-    consumePurchase(transaction);
+    PendingIntent intent;
+    intent.kind = PendingIntent::Finalize;
+    intent.transaction = transaction;
+    if (deferIntent(intent))
+        return;
+
+    qCDebug(lcStore) << "Store: Finalizing transaction" << transaction.orderId;
+    StoreTracer::beginAsync("finalize", transaction.key());
+    requestConsume(transaction);
+}
+
+bool AbstractStoreBackend::deferIntent(PendingIntent intent)
+{
+    // Intents run from the queue, and everything when queuing is off, go straight through
+    if (_runningIntents || _pendingIntentTimeout <= 0)
+        return false;
+
+    // Later intents queue behind earlier ones so they still run in the order they were made
+    if (_pendingIntents.isEmpty() && isIntentReady(intent))
+        return false;
+
+    qCDebug(lcStore) << "Store not ready - queuing" << intent.kind << intent.productId << intent.transaction.orderId;
+    intent.deadline = QDeadlineTimer(_pendingIntentTimeout);
+    _pendingIntents.append(intent);
+    if (!_intentTimer.isActive())
+        expirePendingIntents();
+    return true;
+}
+
+bool AbstractStoreBackend::isIntentReady(const PendingIntent &intent) const
+{
+    if (!isConnected())
+        return false;
+    if (intent.kind != PendingIntent::Purchase)
+        return true;
+
+    // Purchases also wait for the store to confirm their product
+    const ProductCatalog::Handle handle = _catalog.handle(intent.productId);
+    return handle < 0
+           || (_catalog.status(handle) != AbstractProduct::PendingRegistration && !_warmRows.contains(handle));
+}
+
+void AbstractStoreBackend::runPendingIntents()
+{
+    if (_runningIntents)
+        return;
+
+    expirePendingIntents();
+
+    _runningIntents = true;
+    while (!_pendingIntents.isEmpty() && isIntentReady(_pendingIntents.first())) {
+        const PendingIntent intent = _pendingIntents.takeFirst();
+        qCDebug(lcStore) << "Running queued" << intent.kind << intent.productId << intent.transaction.orderId;
+
+        switch (intent.kind) {
+        case PendingIntent::Purchase:
+            if (AbstractProduct * queued = product(intent.productId))
+                queued->purchase();
+            break;
+        case PendingIntent::Restore:
+            restorePurchases();
+            break;
+        case PendingIntent::Finalize:
+            finalize(intent.transaction);
+            break;
+        }
+    }
+    _runningIntents = false;
+
+    expirePendingIntents();
+}
+
+void AbstractStoreBackend::expirePendingIntents()
+{
+    QList<PendingIntent> expired;
+    qint64 nextExpiry = -1;
+    for (auto it = _pendingIntents.begin(); it != _pendingIntents.end();) {
+        if (it->deadline.hasExpired()) {
+            expired.append(*it);
+            it = _pendingIntents.erase(it);
+            continue;
+        }
+        const qint64 remaining = it->deadline.remainingTime();
+        if (nextExpiry < 0 || remaining < nextExpiry)
+            nextExpiry = remaining;
+        ++it;
+    }
+
+    if (nextExpiry < 0)
+        _intentTimer.stop();
+    else
+        _intentTimer.start(static_cast<int>(nextExpiry));
+
+    // Handlers may queue new intents, so report only once the queue is consistent
+    const QString message = "Store was not ready before the request timed out";
+    const int error = static_cast<int>(PurchaseError::ServiceUnavailable);
+    for (const PendingIntent &intent : expired) {
+        qCWarning(lcStore) << "Queued" << intent.kind << intent.productId << "timed out waiting for the store";
+        switch (intent.kind) {
+        case PendingIntent::Purchase:
+            emit purchaseFailed(intent.productId, error, 0, message);
+            break;
+        case PendingIntent::Restore:
+            emit restorePurchasesFailed(error, 0, message);
+            break;
+        case PendingIntent::Finalize:
+            emit consumePurchaseFailed(intent.transaction);
+            break;
+        }
+    }
+}
+
+void AbstractStoreBackend::setRestoreOnConnect(bool restoreOnConnect)
+{
+    if (_restoreOnConnect == restoreOnConnect)
+        return;
+    _restoreOnConnect = restoreOnConnect;
+    emit restoreOnConnectChanged();
+}
+
+void AbstractStoreBackend::setPendingIntentTimeout(int pendingIntentTimeout)
+{
+    if (_pendingIntentTimeout == pendingIntentTimeout)
+        return;
+    _pendingIntentTimeout = pendingIntentTimeout;
+    emit pendingIntentTimeoutChanged();
+}
+
+void AbstractStoreBackend::finalizeAll(const QList<Transaction> &transactions)
+{
+    qCDebug(lcStore) << "Store: Finalizing" << transactions.size() << "transaction(s)";
+
+    FinalizeBatch batch;
+    QList<Transaction> unique;
+    for (const Transaction &transaction : transactions) {
+        // The same transaction is often delivered more than once (e.g. purchase, then restore)
+        const QString key = transaction.key();
+        if (batch.pending.contains(key)) {
+            qCDebug(lcStore) << "Skipping duplicate transaction" << transaction.orderId;
+            continue;
+        }
+        FinalizeResult result;
+        result.transaction = transaction;
+        batch.pending.insert(key, batch.results.size());
+        batch.results.append(result);
+        unique.append(transaction);
+        StoreTracer::beginAsync("finalize", key);
+    }
+
+    if (unique.isEmpty()) {
+        emit finalizeAllCompleted({});
+        return;
+    }
+
+    _finalizeBatches.append(batch);
+    finalizeBatch(unique);
+}
+
+void AbstractStoreBackend::finalizeBatch(const QList<Transaction> &transactions)
+{
+    _finalizeQueue.append(transactions);
+    dispatchFinalizations();
+}
+
+void AbstractStoreBackend::dispatchFinalizations()
+{
+    // consumePurchase() may complete synchronously and free a slot while we are still dispatching
+    if (_dispatchingFinalizations)
+        return;
+
+    _dispatchingFinalizations = true;
+    while (!_finalizeQueue.isEmpty() && _finalizingOrders.size() < _maxConcurrentFinalizations) {
+        const Transaction transaction = _finalizeQueue.takeFirst();
+        trackFinalization(transaction);
+        requestConsume(transaction);
+    }
+    _dispatchingFinalizations = false;
+}
+
+void AbstractStoreBackend::submitFinalization(const QList<Transaction> &transactions, RateLimiter::Call call)
+{
+    for (const Transaction &transaction : transactions)
+        trackFinalization(transaction);
+
+    submitRequest(ConsumeRequest, std::move(call), [this, transactions]() {
+        for (const Transaction &transaction : transactions)
+            emit consumePurchaseFailed(transaction);
+    });
+}
+
+void AbstractStoreBackend::trackFinalization(const Transaction &transaction)
+{
+    const QString key = transaction.key();
+    const quint64 serial = ++_finalizeSerial;
+    _finalizingOrders.insert(key, serial);
+
+    // A store that never answers would otherwise hold the slot, and policy ownership, for good
+    if (_finalizeTimeout > 0) {
+        QTimer::singleShot(_finalizeTimeout, this, [this, transaction, key, serial]() {
+            if (_finalizingOrders.value(key) != serial)
+                return;
+            qCWarning(lcStore) << "Finalizing" << transaction.orderId << "timed out";
+            emit consumePurchaseFailed(transaction);
+        });
+    }
+}
+
+void AbstractStoreBackend::requestConsume(const Transaction &transaction)
+{
+    const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+    if (_consumptions.window() > 0 && handle >= 0 && _catalog.productType(handle) == AbstractProduct::Consumable) {
+        _consumptions.add(transaction);
+        return;
+    }
+
+    submitRequest(
+        ConsumeRequest,
+        [this, transaction]() { consumePurchase(transaction); },
+        [this, transaction]() { emit consumePurchaseFailed(transaction); }
+    );
+}
+
+void AbstractStoreBackend::consumeAggregated(const QList<Transaction> &transactions)
+{
+    qCDebug(lcStore) << "Consuming" << transactions.size() << "unit(s) of" << transactions.first().productId;
+
+    // One request for the group when the store consumes by quantity
+    submitRequest(
+        ConsumeRequest,
+        [this, transactions]() {
+            if (consumeQuantity(transactions))
+                return;
+            for (const Transaction &transaction : transactions)
+                consumePurchase(transaction);
+        },
+        [this, transactions]() { finishConsumeQuantity(transactions, false); }
+    );
+}
+
+bool AbstractStoreBackend::consumeQuantity(const QList<Transaction> &transactions)
+{
+    Q_UNUSED(transactions)
+    return false;
+}
+
+void AbstractStoreBackend::finishConsumeQuantity(const QList<Transaction> &transactions, bool succeeded)
+{
+    // Every transaction in the group shares the outcome of the single store call
+    for (const Transaction &transaction : transactions) {
+        if (succeeded)
+            emit consumePurchaseSucceeded(transaction);
+        else
+            emit consumePurchaseFailed(transaction);
+    }
+}
+
+void AbstractStoreBackend::setFinalizeTimeout(int finalizeTimeout)
+{
+    finalizeTimeout = qMax(0, finalizeTimeout);
+    if (_finalizeTimeout == finalizeTimeout)
+        return;
+    _finalizeTimeout = finalizeTimeout;
+    emit finalizeTimeoutChanged();
+}
+
+void AbstractStoreBackend::setConsumptionWindow(int consumptionWindow)
+{
+    if (_consumptions.window() == consumptionWindow)
+        return;
+    _consumptions.setWindow(consumptionWindow);
+    emit consumptionWindowChanged();
+}
+
+void AbstractStoreBackend::finishFinalization(const Transaction &transaction, bool succeeded)
+{
+    const QString key = transaction.key();
+
+    // A failed finalization must be redelivered so it can be retried
+    _policyOwnedOrders.remove(key);
+
+    for (qsizetype i = 0; i < _finalizeBatches.size(); ++i) {
+        FinalizeBatch &batch = _finalizeBatches[i];
+        const qsizetype index = batch.pending.value(key, -1);
+        if (index < 0)
+            continue;
+
+        batch.pending.remove(key);
+        batch.results[index].succeeded = succeeded;
+        if (batch.pending.isEmpty()) {
+            const QList<FinalizeResult> results = _finalizeBatches.takeAt(i).results;
+            emit finalizeAllCompleted(results);
+        }
+        break;
+    }
+
+    if (_finalizingOrders.remove(key))
+        dispatchFinalizations();
+}
+
+void AbstractStoreBackend::applyFinalizePolicy(ProductCatalog::Handle handle, const Transaction &transaction)
+{
+    AbstractProduct::FinalizePolicy policy = _finalizePolicy;
+    if (AbstractProduct * ap = _catalog.facade(handle)) {
+        if (ap->finalizePolicy() != AbstractProduct::StoreFinalizePolicy)
+            policy = ap->finalizePolicy();
+    }
+
+    switch (policy) {
+    case AbstractProduct::AutoFinalize:
+        // Handlers are direct connections, so they have all returned by now
+        scheduleFinalize(transaction);
+        break;
+    case AbstractProduct::AcknowledgedFinalize:
+        _policyOwnedOrders.insert(transaction.key());
+        break;
+    default:
+        break;
+    }
+}
+
+void AbstractStoreBackend::acknowledge(Transaction transaction)
+{
+    qCDebug(lcStore) << "Store: Acknowledged transaction" << transaction.orderId;
+    scheduleFinalize(transaction);
+}
+
+void AbstractStoreBackend::scheduleFinalize(const Transaction &transaction)
+{
+    _policyOwnedOrders.insert(transaction.key());
+
+    // Everything scheduled in this event loop iteration goes out as one batch
+    if (_scheduledFinalizations.isEmpty())
+        QTimer::singleShot(0, this, &AbstractStoreBackend::flushScheduledFinalizations);
+    _scheduledFinalizations.append(transaction);
+}
+
+void AbstractStoreBackend::flushScheduledFinalizations()
+{
+    const QList<Transaction> transactions = std::exchange(_scheduledFinalizations, {});
+    if (!transactions.isEmpty())
+        finalizeAll(transactions);
+}
+
+void AbstractStoreBackend::setFinalizePolicy(AbstractProduct::FinalizePolicy policy)
+{
+    // The store has no policy of its own to defer to
+    if (policy == AbstractProduct::StoreFinalizePolicy)
+        policy = AbstractProduct::ManualFinalize;
+
+    if (_finalizePolicy == policy)
+        return;
+
+    _finalizePolicy = policy;
+    emit finalizePolicyChanged();
+}
+
+void AbstractStoreBackend::setMaxConcurrentFinalizations(int maxConcurrentFinalizations)
+{
+    maxConcurrentFinalizations = qMax(1, maxConcurrentFinalizations);
+    if (_maxConcurrentFinalizations == maxConcurrentFinalizations)
+        return;
+
+    _maxConcurrentFinalizations = maxConcurrentFinalizations;
+    emit maxConcurrentFinalizationsChanged();
+    dispatchFinalizations();
 }
 
 void AbstractStoreBackend::enableProcessing()
@@ -154,7 +1405,30 @@ void AbstractStoreBackend::enableProcessing()
     if (_processingEnabled)
         return;
     _processingEnabled = true;
-    emit processingEnabledChanged();
+    _notifications.notify(this, &AbstractStoreBackend::processingEnabledChanged);
+    recordMilestone(StartupMilestones::ProcessingEnabled);
+
+    processQueuedTransactions();
+    // Handled after any events the backend posted while processing its queue
+    StoreEvent drained;
+    drained.type = QueuedTransactionsDrainedEvent;
+    _storeEvents.post(std::move(drained));
+}
+
+void AbstractStoreBackend::setCoalesceNotifications(bool coalesce)
+{
+    if (_notifications.isEnabled() == coalesce)
+        return;
+    _notifications.setEnabled(coalesce);
+    emit coalesceNotificationsChanged();
+}
+
+void AbstractStoreBackend::setDecodeStoreEventsInBackground(bool background)
+{
+    if (_storeEvents.decodesInBackground() == background)
+        return;
+    _storeEvents.setDecodeInBackground(background);
+    emit decodeStoreEventsInBackgroundChanged();
 }
 
 void AbstractStoreBackend::setConnected(bool connected)
@@ -164,7 +1438,7 @@ void AbstractStoreBackend::setConnected(bool connected)
 
     _connected = connected;
     emit connectedChanged();
-    qDebug() << "Store connection status changed to" << (_connected ? "connected" : "disconnected");
+    qCDebug(lcStore) << "Store connection status changed to" << (_connected ? "connected" : "disconnected");
 }
 
 void AbstractStoreBackend::setCanMakePurchases(bool canMakePurchases)
@@ -173,8 +1447,8 @@ void AbstractStoreBackend::setCanMakePurchases(bool canMakePurchases)
         return;
 
     _canMakePurchases = canMakePurchases;
-    emit canMakePurchasesChanged();
-    qDebug() << "Store canMakePurchases status changed to" << (_canMakePurchases ? "enabled" : "disabled");
+    _notifications.notify(this, &AbstractStoreBackend::canMakePurchasesChanged);
+    qCDebug(lcStore) << "Store canMakePurchases status changed to" << (_canMakePurchases ? "enabled" : "disabled");
 }
 
 void AbstractStoreBackend::setIsRestoringPurchases(bool restoring)
@@ -183,37 +1457,17 @@ void AbstractStoreBackend::setIsRestoringPurchases(bool restoring)
         return;
 
     _isRestoringPurchases = restoring;
-    emit isRestoringPurchasesChanged();
-    qDebug() << "Store isRestoringPurchases status changed to" << (_isRestoringPurchases ? "true" : "false");
-}
-
-// Static QQmlListProperty accessors
-void AbstractStoreBackend::appendProduct(QQmlListProperty<AbstractProduct> * list, AbstractProduct * product)
-{
-    AbstractStoreBackend * store = qobject_cast<AbstractStoreBackend *>(list->object);
-    if (store && product) {
-        store->_products.append(product);
-        emit store->productsChanged();
-    }
+    _notifications.notify(this, &AbstractStoreBackend::isRestoringPurchasesChanged);
+    qCDebug(lcStore) << "Store isRestoringPurchases status changed to" << (_isRestoringPurchases ? "true" : "false");
 }
 
-qsizetype AbstractStoreBackend::productCount(QQmlListProperty<AbstractProduct> * list)
+void AbstractStoreBackend::clearProducts()
 {
-    AbstractStoreBackend * store = qobject_cast<AbstractStoreBackend *>(list->object);
-    return store ? store->_products.count() : 0;
-}
-
-AbstractProduct * AbstractStoreBackend::productAt(QQmlListProperty<AbstractProduct> * list, qsizetype index)
-{
-    AbstractStoreBackend * store = qobject_cast<AbstractStoreBackend *>(list->object);
-    return (store && index >= 0 && index < store->_products.count()) ? store->_products.at(index) : nullptr;
-}
-
-void AbstractStoreBackend::clearProducts(QQmlListProperty<AbstractProduct> * list)
-{
-    AbstractStoreBackend * store = qobject_cast<AbstractStoreBackend *>(list->object);
-    if (store) {
-        store->_products.clear();
-        emit store->productsChanged();
-    }
+    detachProducts();
+    _catalog.clear();
+    _warmRows.clear();
+    _warmRegistering.clear();
+    _refreshing.clear();
+    _searchIndex.clear();
+    _notifications.notify(this, &AbstractStoreBackend::productsChanged);
 }
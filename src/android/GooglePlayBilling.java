@@ -26,6 +26,7 @@ public class GooglePlayBilling {
     private static native void purchaseRestored(String purchaseJson);
     private static native void purchaseFailed(String productId, int billingResponseCode);
     private static native void purchaseConsumed(String purchaseJson);
+    private static native void purchaseConsumeFailed(String purchaseJson, int billingResponseCode);
     private static native void restorePurchasesSucceeded(int count);
     private static native void restorePurchasesFailed(int billingResponseCode);
 
@@ -103,9 +104,8 @@ public class GooglePlayBilling {
             public void onBillingSetupFinished(BillingResult billingResult) {
                 billingResponseReceived(billingResult.getResponseCode());
                 if (billingResult.getResponseCode() ==  BillingResponseCode.OK) {
+                    // The store queries existing purchases once connected (restoreOnConnect)
                     connectedChangedHelper(true);
-                    // The BillingClient is ready. query purchases here.
-                    billingClient.queryPurchasesAsync(SkuType.INAPP, purchasesResponseListener);
 
                 } else {
                     connectedChangedHelper(false);
@@ -171,6 +171,8 @@ public class GooglePlayBilling {
             public void onConsumeResponse (BillingResult billingResult, String purchaseToken) {
                 if (billingResult.getResponseCode() == BillingResponseCode.OK) {
                     purchaseConsumed(jsonPurchaseString);
+                } else {
+                    purchaseConsumeFailed(jsonPurchaseString, billingResult.getResponseCode());
                 }
             }
         };
@@ -186,7 +188,8 @@ public class GooglePlayBilling {
             billingClient.consumeAsync(consumeParams, listener);
 
         } catch (JSONException e) {
-            throw new RuntimeException(e);
+            debugMessage("consumePurchase: invalid purchase JSON - " + e.getMessage());
+            purchaseConsumeFailed(jsonPurchaseString, BillingResponseCode.DEVELOPER_ERROR);
         }
     }
 
@@ -48,6 +48,7 @@ GooglePlayStoreBackend::GooglePlayStoreBackend(QObject * parent) : AbstractStore
         {"purchaseRestored", "(Ljava/lang/String;)V", reinterpret_cast<void *>(purchaseRestored)},
         {"purchaseFailed", "(Ljava/lang/String;I)V", reinterpret_cast<void *>(purchaseFailed)},
         {"purchaseConsumed", "(Ljava/lang/String;)V", reinterpret_cast<void *>(purchaseConsumed)},
+        {"purchaseConsumeFailed", "(Ljava/lang/String;I)V", reinterpret_cast<void *>(purchaseConsumeFailed)},
         {"restorePurchasesSucceeded", "(I)V", reinterpret_cast<void *>(restorePurchasesSucceeded)},
         {"restorePurchasesFailed", "(I)V", reinterpret_cast<void *>(restorePurchasesFailed)},
     };
@@ -56,6 +57,13 @@ GooglePlayStoreBackend::GooglePlayStoreBackend(QObject * parent) : AbstractStore
     env->RegisterNatives(objectClass, methods, sizeof(methods) / sizeof(methods[0]));
     env->DeleteLocalRef(objectClass);
 
+    // Existing purchases are queried on every connection, alongside product registration
+    setRestoreOnConnect(true);
+
+    // SKU and purchase JSON is parsed on a worker thread, away from the GUI
+    setStoreEventDecoder(&GooglePlayStoreBackend::decodeStoreEvent);
+    setDecodeStoreEventsInBackground(true);
+
     this->startConnection();
 
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
@@ -73,123 +81,100 @@ GooglePlayStoreBackend::~GooglePlayStoreBackend()
 /*static*/ void GooglePlayStoreBackend::debugMessage(JNIEnv * env, jobject object, jstring message)
 {
     const char * messageCStr = env->GetStringUTFChars(message, nullptr);
-    qDebug() << messageCStr;
+    qCDebug(lcStore) << messageCStr;
     env->ReleaseStringUTFChars(message, messageCStr);
 }
 
 /*static*/ void GooglePlayStoreBackend::billingResponseReceived(JNIEnv * env, jobject object, jint value)
 {
-    qDebug() << "Billing response received:" << static_cast<GooglePlayStoreBackend::BillingResponseCode>(value);
+    qCDebug(lcStore) << "Billing response received:" << static_cast<GooglePlayStoreBackend::BillingResponseCode>(value);
 }
 
 /*static*/ void GooglePlayStoreBackend::connectedChangedHelper(JNIEnv * env, jobject object, jboolean connected)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play billing callback received but backend instance is null";
-        return;
-    }
-    backend->setConnected(connected);
-    backend->setCanMakePurchases(backend->canMakePurchases());
+    StoreEvent event;
+    event.type = ConnectedChangedEvent;
+    event.code = connected;
+    postFromJava(std::move(event));
 }
-
 void GooglePlayStoreBackend::startConnection()
 {
     _googlePlayBillingJavaClass->callMethod<void>("startConnection");
 }
 
-void GooglePlayStoreBackend::registerProduct(AbstractProduct * product)
+void GooglePlayStoreBackend::registerProduct(const QString &identifier)
 {
     _googlePlayBillingJavaClass->callMethod<void>(
-        "registerProduct", "(Ljava/lang/String;)V", QJniObject::fromString(product->identifier()).object<jstring>()
+        "registerProduct", "(Ljava/lang/String;)V", QJniObject::fromString(identifier).object<jstring>()
     );
 }
 
-/*static*/ void GooglePlayStoreBackend::productRegistered(JNIEnv * env, jobject object, jstring message)
+AbstractProduct * GooglePlayStoreBackend::createProduct(ProductCatalog::Handle handle)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play product registration callback received but backend instance is null";
-        return;
-    }
-
-    const char * jsonCStr = env->GetStringUTFChars(message, nullptr);
-    QJsonObject json = QJsonDocument::fromJson(jsonCStr).object();
-    env->ReleaseStringUTFChars(message, jsonCStr);
-
-    GooglePlayStoreProduct * product =
-        reinterpret_cast<GooglePlayStoreProduct *>(backend->product(json["productId"].toString()));
-
-    if (product) {
-        product->setJson(json);
-        product->setDescription(json["description"].toString());
-        product->setPrice(json["price"].toString());
-        product->setTitle(json["title"].toString());
-        product->setStatus(AbstractProduct::Registered);
+    return new GooglePlayStoreProduct();
+}
 
-        emit backend->productRegistered(product);
-    } else {
-        qCritical() << "Registered a product that's not in the list of products. This is not handled.";
-    }
+/*static*/ void GooglePlayStoreBackend::productRegistered(JNIEnv * env, jobject object, jstring message)
+{
+    StoreEvent event;
+    event.type = ProductRegisteredEvent;
+    event.text = fromJavaString(env, message);
+    postFromJava(std::move(event));
 }
 
 /*static*/ void GooglePlayStoreBackend::productRegistrationFailed(
     JNIEnv * env, jobject object, jstring productId, jint billingResponseCode
 )
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play product registration failed callback received but backend instance is null";
-        return;
-    }
-
-    const char * productIdCStr = env->GetStringUTFChars(productId, nullptr);
-    QString prodId = QString::fromUtf8(productIdCStr);
-    env->ReleaseStringUTFChars(productId, productIdCStr);
-
-    qWarning() << "Product registration failed for" << prodId << "with billing response code:" << billingResponseCode;
-
-    AbstractProduct * product = backend->product(prodId);
-    if (product)
-        product->setStatus(AbstractProduct::Unknown);
-    else
-        qWarning() << "Could not find product to update status:" << prodId;
+    StoreEvent event;
+    event.type = ProductRegistrationFailedEvent;
+    event.text = fromJavaString(env, productId);
+    event.platformCode = billingResponseCode;
+    postFromJava(std::move(event));
 }
-
 void GooglePlayStoreBackend::purchaseProduct(AbstractProduct * product)
 {
-    QByteArray jsonSkuDetails = QJsonDocument(reinterpret_cast<GooglePlayStoreProduct *>(product)->json()).toJson();
+    // The SKU details exactly as Google Play reported them; no need to re-serialise
+    const QByteArray skuDetails = product->platformPayload();
+    if (skuDetails.isEmpty()) {
+        qCWarning(lcStore) << "Cannot purchase" << product->identifier() << "- no SKU details received yet";
+        emit purchaseFailed(
+            product->identifier(), static_cast<int>(PurchaseError::ItemUnavailable), 0, "Product details not loaded"
+        );
+        return;
+    }
 
     _googlePlayBillingJavaClass->callMethod<void>(
         "purchaseProduct",
         "(Landroid/app/Activity;Ljava/lang/String;)V",
         QNativeInterface::QAndroidApplication::context(),
-        QJniObject::fromString(jsonSkuDetails).object<jstring>()
+        QJniObject::fromString(QString::fromUtf8(skuDetails)).object<jstring>()
     );
 }
 
 void GooglePlayStoreBackend::consumePurchase(Transaction transaction)
 {
-    qDebug() << "Android consumePurchase called for:" << transaction.orderId
-             << "purchaseToken:" << transaction.purchaseToken;
+    qCDebug(lcStore) << "Android consumePurchase called for:" << transaction.orderId
+                     << "purchaseToken:" << transaction.purchaseToken;
 
     // Only call consumeAsync for Consumable products
-    AbstractProduct * product = this->product(transaction.productId);
-    if (!product) {
-        qWarning() << "Cannot find product for transaction:" << transaction.productId;
+    const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
+    if (handle < 0) {
+        qCWarning(lcStore) << "Cannot find product for transaction:" << transaction.productId;
         emit consumePurchaseFailed(transaction);
         return;
     }
 
     // Only consumables need fulfillment
-    if (product->productType() != AbstractProduct::Consumable) {
-        qDebug() << "Product is not consumable (type:" << product->productType() << "), no fulfillment needed";
+    const AbstractProduct::ProductType productType = _catalog.productType(handle);
+    if (productType != AbstractProduct::Consumable) {
+        qCDebug(lcStore) << "Product is not consumable (type:" << productType << "), no fulfillment needed";
         emit consumePurchaseSucceeded(transaction);
         return;
     }
 
     // For consumables, we need to report fulfillment to Google Play Store
-    qDebug() << "Android: consumePurchase called for" << transaction.orderId;
+    qCDebug(lcStore) << "Android: consumePurchase called for" << transaction.orderId;
 
     _googlePlayBillingJavaClass->callMethod<void>(
         "consumePurchase",
@@ -200,7 +185,7 @@ void GooglePlayStoreBackend::consumePurchase(Transaction transaction)
 
 void GooglePlayStoreBackend::restorePurchasesImpl()
 {
-    qDebug() << "Android restorePurchasesImpl() called - triggering manual queryPurchasesAsync";
+    qCDebug(lcStore) << "Android restorePurchasesImpl() called - triggering manual queryPurchasesAsync";
     _googlePlayBillingJavaClass->callMethod<void>("queryExistingPurchases");
 }
 
@@ -212,139 +197,236 @@ bool GooglePlayStoreBackend::canMakePurchases() const
 
 /*static*/ void GooglePlayStoreBackend::purchaseSucceeded(JNIEnv * env, jobject object, jstring message)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play purchase callback received but backend instance is null";
-        return;
-    }
+    StoreEvent event;
+    event.type = PurchaseSucceededEvent;
+    event.text = fromJavaString(env, message);
+    postFromJava(std::move(event));
+}
 
-    const char * jsonCStr = env->GetStringUTFChars(message, nullptr);
-    QJsonObject json = QJsonDocument::fromJson(jsonCStr).object();
-    env->ReleaseStringUTFChars(message, jsonCStr);
+/*static*/ void GooglePlayStoreBackend::purchasePending(JNIEnv * env, jobject object, jstring message)
+{
+    StoreEvent event;
+    event.type = PurchasePendingEvent;
+    event.text = fromJavaString(env, message);
+    postFromJava(std::move(event));
+}
 
-    if (!backend->processingEnabled()) {
-        qDebug() << "Android: purchaseSucceeded received but processing not enabled - queueing";
-        backend->_queuedPurchaseSucceeded.append(json);
-        return;
-    }
+/*static*/ void GooglePlayStoreBackend::purchaseRestored(JNIEnv * env, jobject object, jstring message)
+{
+    StoreEvent event;
+    event.type = PurchaseRestoredEvent;
+    event.text = fromJavaString(env, message);
+    postFromJava(std::move(event));
+}
 
-    auto transaction = transactionFromJson(json);
-    emit backend->purchaseSucceeded(transaction);
+/*static*/ void
+GooglePlayStoreBackend::purchaseFailed(JNIEnv * env, jobject object, jstring productId, jint billingResponseCode)
+{
+    StoreEvent event;
+    event.type = PurchaseFailedEvent;
+    event.text = fromJavaString(env, productId);
+    event.platformCode = billingResponseCode;
+    postFromJava(std::move(event));
 }
 
-/*static*/ void GooglePlayStoreBackend::purchasePending(JNIEnv * env, jobject object, jstring message)
+/*static*/ void GooglePlayStoreBackend::purchaseConsumed(JNIEnv * env, jobject object, jstring message)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play pending purchase callback received but backend instance is null";
-        return;
-    }
+    StoreEvent event;
+    event.type = PurchaseConsumedEvent;
+    event.text = fromJavaString(env, message);
+    postFromJava(std::move(event));
+}
 
-    const char * jsonCStr = env->GetStringUTFChars(message, nullptr);
-    QJsonObject json = QJsonDocument::fromJson(jsonCStr).object();
-    env->ReleaseStringUTFChars(message, jsonCStr);
+/*static*/ void GooglePlayStoreBackend::purchaseConsumeFailed(
+    JNIEnv * env, jobject object, jstring message, jint billingResponseCode
+)
+{
+    StoreEvent event;
+    event.type = PurchaseConsumeFailedEvent;
+    event.text = fromJavaString(env, message);
+    event.platformCode = billingResponseCode;
+    postFromJava(std::move(event));
+}
 
-    if (!backend->processingEnabled()) {
-        qDebug() << "Android: purchasePending received but processing not enabled - queueing";
-        backend->_queuedPurchasePending.append(json);
-        return;
-    }
+/*static*/ void GooglePlayStoreBackend::restorePurchasesSucceeded(JNIEnv * env, jobject object, jint count)
+{
+    StoreEvent event;
+    event.type = RestoreSucceededEvent;
+    event.code = count;
+    postFromJava(std::move(event));
+}
 
-    auto transaction = transactionFromJson(json);
-    qDebug() << "Android purchase pending for product:" << transaction.productId;
+/*static*/ void GooglePlayStoreBackend::restorePurchasesFailed(JNIEnv * env, jobject object, jint billingResponseCode)
+{
+    StoreEvent event;
+    event.type = RestoreFailedEvent;
+    event.platformCode = billingResponseCode;
+    postFromJava(std::move(event));
+}
 
-    // Find the product and emit a pending signal
-    AbstractProduct * product = backend->product(transaction.productId);
-    if (product) {
-        qDebug() << "Emitting purchase pending for product:" << transaction.productId;
-        emit backend->purchasePending(transaction);
-    } else {
-        qWarning() << "Could not find product for pending purchase:" << transaction.productId;
-    }
+/*static*/ QString GooglePlayStoreBackend::fromJavaString(JNIEnv * env, jstring string)
+{
+    const char * utf8 = env->GetStringUTFChars(string, nullptr);
+    QString result = QString::fromUtf8(utf8);
+    env->ReleaseStringUTFChars(string, utf8);
+    return result;
 }
 
-/*static*/ void GooglePlayStoreBackend::purchaseRestored(JNIEnv * env, jobject object, jstring message)
+/*static*/ void GooglePlayStoreBackend::postFromJava(StoreEvent event)
 {
+    // Called on Java binder threads: only record the event, the GUI thread handles it
     GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
     if (!backend) {
-        qCritical() << "Google Play purchase callback received but backend instance is null";
+        qCCritical(lcStore) << "Google Play billing callback received but backend instance is null; event"
+                            << event.type;
         return;
     }
+    backend->postStoreEvent(std::move(event));
+}
 
-    const char * jsonCStr = env->GetStringUTFChars(message, nullptr);
-    QJsonObject json = QJsonDocument::fromJson(jsonCStr).object();
-    env->ReleaseStringUTFChars(message, jsonCStr);
-
-    if (!backend->processingEnabled()) {
-        qDebug() << "Android: purchaseRestored received but processing not enabled - queueing";
-        backend->_queuedPurchaseRestored.append(json);
-        return;
+/*static*/ void GooglePlayStoreBackend::decodeStoreEvent(StoreEvent &event)
+{
+    // Runs on the decoder thread: touches nothing but the event
+    switch (static_cast<EventType>(event.type)) {
+    case ProductRegisteredEvent: {
+        event.payload = event.text.toUtf8();
+        const QJsonObject json = QJsonDocument::fromJson(event.payload).object();
+        event.text = json["productId"].toString();
+        event.storeData.title = json["title"].toString();
+        event.storeData.description = json["description"].toString();
+        event.storeData.price = json["price"].toString();
+        event.storeData.priceMicros = json["price_amount_micros"].toInteger(-1);
+        event.storeData.currencyCode = json["price_currency_code"].toString();
+    } break;
+    case PurchaseSucceededEvent:
+    case PurchasePendingEvent:
+    case PurchaseRestoredEvent:
+    case PurchaseConsumedEvent:
+    case PurchaseConsumeFailedEvent:
+        event.transaction = transactionFromJson(QJsonDocument::fromJson(event.text.toUtf8()).object());
+        break;
+    default:
+        break;
     }
+}
 
-    auto transaction = transactionFromJson(json);
-    emit backend->purchaseRestored(transaction);
+void GooglePlayStoreBackend::handleStoreEvent(const StoreEvent &event)
+{
+    switch (static_cast<EventType>(event.type)) {
+    case ConnectedChangedEvent:
+        setConnected(event.code);
+        setCanMakePurchases(canMakePurchases());
+        break;
+    case ProductRegisteredEvent:
+        handleProductRegistered(event);
+        break;
+    case ProductRegistrationFailedEvent:
+        handleProductRegistrationFailed(event.text, event.platformCode);
+        break;
+    case PurchaseSucceededEvent:
+        handlePurchaseSucceeded(event.transaction);
+        break;
+    case PurchasePendingEvent:
+        handlePurchasePending(event.transaction);
+        break;
+    case PurchaseRestoredEvent:
+        handlePurchaseRestored(event.transaction);
+        break;
+    case PurchaseFailedEvent: {
+        PurchaseError error = mapBillingResponseToPurchaseError(event.platformCode);
+        QString message = getBillingResponseMessage(event.platformCode);
+        emit purchaseFailed(event.text, static_cast<int>(error), event.platformCode, message);
+    } break;
+    case PurchaseConsumedEvent:
+        emit consumePurchaseSucceeded(event.transaction);
+        break;
+    case PurchaseConsumeFailedEvent:
+        qCWarning(lcStore) << "Android: consuming" << event.transaction.orderId
+                           << "failed with billing response code:" << event.platformCode;
+        emit consumePurchaseFailed(event.transaction);
+        break;
+    case RestoreSucceededEvent:
+        qCDebug(lcStore) << "Android: Restore purchases completed successfully. Count:" << event.code;
+        emit restorePurchasesSucceeded(event.code);
+        break;
+    case RestoreFailedEvent: {
+        qCDebug(lcStore) << "Android: Restore purchases failed with billing response code:" << event.platformCode;
+        PurchaseError mappedError = mapBillingResponseToPurchaseError(event.platformCode);
+        QString message = getBillingResponseMessage(event.platformCode);
+        emit restorePurchasesFailed(static_cast<int>(mappedError), event.platformCode, message);
+    } break;
+    }
 }
 
-/*static*/ void
-GooglePlayStoreBackend::purchaseFailed(JNIEnv * env, jobject object, jstring productId, jint billingResponseCode)
+void GooglePlayStoreBackend::handleProductRegistered(const StoreEvent &event)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play purchase callback received but backend instance is null";
-        return;
+    // Decoded by decodeStoreEvent(): text holds the product id, payload the SKU details JSON
+    const ProductCatalog::Handle handle = _catalog.handle(event.text);
+
+    if (handle >= 0) {
+        const bool refresh = isRefreshing(handle);
+        _catalog.setPlatformPayload(handle, event.payload);
+        applyStoreData(handle, event.storeData, AbstractProduct::Registered);
+
+        AbstractProduct * product = _catalog.facade(handle);
+        if (product && !refresh)
+            emit productRegistered(product);
+    } else {
+        qCCritical(lcStore) << "Registered a product that's not in the list of products. This is not handled.";
     }
+}
 
-    const char * productIdCStr = env->GetStringUTFChars(productId, nullptr);
-    QString prodId = QString::fromUtf8(productIdCStr);
-    env->ReleaseStringUTFChars(productId, productIdCStr);
+void GooglePlayStoreBackend::handleProductRegistrationFailed(const QString &productId, int billingResponseCode)
+{
+    qCWarning(lcStore) << "Product registration failed for" << productId
+                       << "with billing response code:" << billingResponseCode;
 
-    PurchaseError error = mapBillingResponseToPurchaseError(billingResponseCode);
-    QString message = getBillingResponseMessage(billingResponseCode);
-    emit backend->purchaseFailed(prodId, static_cast<int>(error), billingResponseCode, message);
+    const ProductCatalog::Handle handle = _catalog.handle(productId);
+    if (handle >= 0)
+        setProductStatus(handle, AbstractProduct::Unknown);
+    else
+        qCWarning(lcStore) << "Could not find product to update status:" << productId;
 }
 
-/*static*/ void GooglePlayStoreBackend::purchaseConsumed(JNIEnv * env, jobject object, jstring message)
+void GooglePlayStoreBackend::handlePurchaseSucceeded(const Transaction &transaction)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qCritical() << "Google Play purchase callback received but backend instance is null";
+    if (!processingEnabled()) {
+        qCDebug(lcStore) << "Android: purchaseSucceeded received but processing not enabled - queueing";
+        _queuedPurchaseSucceeded.append(transaction);
         return;
     }
 
-    const char * jsonCStr = env->GetStringUTFChars(message, nullptr);
-    QJsonObject json = QJsonDocument::fromJson(jsonCStr).object();
-    env->ReleaseStringUTFChars(message, jsonCStr);
-
-    auto transaction = transactionFromJson(json);
-    emit backend->consumePurchaseSucceeded(transaction);
+    emit purchaseSucceeded(transaction);
 }
 
-/*static*/ void GooglePlayStoreBackend::restorePurchasesSucceeded(JNIEnv * env, jobject object, jint count)
+void GooglePlayStoreBackend::handlePurchasePending(const Transaction &transaction)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qWarning() << "Android: restorePurchasesSucceeded received but backend instance is null";
+    if (!processingEnabled()) {
+        qCDebug(lcStore) << "Android: purchasePending received but processing not enabled - queueing";
+        _queuedPurchasePending.append(transaction);
         return;
     }
 
-    qDebug() << "Android: Restore purchases completed successfully. Count:" << count;
-    emit backend->restorePurchasesSucceeded(count);
+    qCDebug(lcStore) << "Android purchase pending for product:" << transaction.productId;
+
+    // Find the product and emit a pending signal
+    if (_catalog.handle(transaction.productId) >= 0) {
+        qCDebug(lcStore) << "Emitting purchase pending for product:" << transaction.productId;
+        emit purchasePending(transaction);
+    } else {
+        qCWarning(lcStore) << "Could not find product for pending purchase:" << transaction.productId;
+    }
 }
 
-/*static*/ void GooglePlayStoreBackend::restorePurchasesFailed(JNIEnv * env, jobject object, jint billingResponseCode)
+void GooglePlayStoreBackend::handlePurchaseRestored(const Transaction &transaction)
 {
-    GooglePlayStoreBackend * backend = GooglePlayStoreBackend::s_currentInstance;
-    if (!backend) {
-        qWarning() << "Android: restorePurchasesFailed received but backend instance is null";
+    if (!processingEnabled()) {
+        qCDebug(lcStore) << "Android: purchaseRestored received but processing not enabled - queueing";
+        _queuedPurchaseRestored.append(transaction);
         return;
     }
 
-    qDebug() << "Android: Restore purchases failed with billing response code:" << billingResponseCode;
-
-    PurchaseError mappedError = mapBillingResponseToPurchaseError(billingResponseCode);
-    QString message = getBillingResponseMessage(billingResponseCode);
-
-    emit backend->restorePurchasesFailed(static_cast<int>(mappedError), billingResponseCode, message);
+    emit purchaseRestored(transaction);
 }
 
 /*static*/ AbstractStoreBackend::PurchaseError
@@ -409,47 +491,30 @@ GooglePlayStoreBackend::mapBillingResponseToPurchaseError(int billingResponseCod
     }
 }
 
-void GooglePlayStoreBackend::enableProcessing()
-{
-    if (processingEnabled())
-        return;
-
-    AbstractStoreBackend::enableProcessing();
-
-    qDebug() << "Android: Processing enabled - processing queued transactions";
-    processQueuedTransactions();
-}
-
 void GooglePlayStoreBackend::processQueuedTransactions()
 {
-    qDebug() << "Android: Processing" << _queuedPurchaseSucceeded.size() << "queued purchaseSucceeded,"
-             << _queuedPurchaseRestored.size() << "queued purchaseRestored," << _queuedPurchasePending.size()
-             << "queued purchasePending";
+    qCDebug(lcStore) << "Android: Processing" << _queuedPurchaseSucceeded.size() << "queued purchaseSucceeded,"
+                     << _queuedPurchaseRestored.size() << "queued purchaseRestored," << _queuedPurchasePending.size()
+                     << "queued purchasePending";
 
     // Process queued purchase succeeded
-    for (const auto &json : _queuedPurchaseSucceeded) {
-        auto transaction = transactionFromJson(json);
+    for (const auto &transaction : _queuedPurchaseSucceeded)
         emit purchaseSucceeded(transaction);
-    }
     _queuedPurchaseSucceeded.clear();
 
     // Process queued purchase restored
-    for (const auto &json : _queuedPurchaseRestored) {
-        auto transaction = transactionFromJson(json);
+    for (const auto &transaction : _queuedPurchaseRestored)
         emit purchaseRestored(transaction);
-    }
     _queuedPurchaseRestored.clear();
 
     // Process queued purchase pending
-    for (const auto &json : _queuedPurchasePending) {
-        auto transaction = transactionFromJson(json);
-        qDebug() << "Processing queued Android purchase pending for product:" << transaction.productId;
+    for (const auto &transaction : _queuedPurchasePending) {
+        qCDebug(lcStore) << "Processing queued Android purchase pending for product:" << transaction.productId;
 
-        AbstractProduct * product = this->product(transaction.productId);
-        if (product) {
+        if (_catalog.handle(transaction.productId) >= 0) {
             emit purchasePending(transaction);
         } else {
-            qWarning() << "Could not find product for queued pending purchase:" << transaction.productId;
+            qCWarning(lcStore) << "Could not find product for queued pending purchase:" << transaction.productId;
         }
     }
     _queuedPurchasePending.clear();
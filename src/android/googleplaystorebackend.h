@@ -10,7 +10,6 @@
 class GooglePlayStoreBackend : public AbstractStoreBackend
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(Store)
 
 public:
     enum BillingResponseCode {
@@ -42,30 +41,54 @@ public:
     static void purchaseRestored(JNIEnv * env, jobject object, jstring purchaseJson);
     static void purchaseFailed(JNIEnv * env, jobject object, jstring productId, jint billingResponseCode);
     static void purchaseConsumed(JNIEnv * env, jobject object, jstring purchaseJson);
+    static void purchaseConsumeFailed(JNIEnv * env, jobject object, jstring purchaseJson, jint billingResponseCode);
     static void restorePurchasesSucceeded(JNIEnv * env, jobject object, jint count);
     static void restorePurchasesFailed(JNIEnv * env, jobject object, jint billingResponseCode);
 
     void startConnection() override;
-    void registerProduct(AbstractProduct * product) override;
+    void registerProduct(const QString &identifier) override;
     void purchaseProduct(AbstractProduct * product) override;
     void consumePurchase(Transaction transaction) override;
     bool canMakePurchases() const override;
 
-    // Transaction processing control
-    void enableProcessing() override;
-
 protected:
     void restorePurchasesImpl() override;
+    void processQueuedTransactions() override;
+    AbstractProduct * createProduct(ProductCatalog::Handle handle) override;
+    void handleStoreEvent(const StoreEvent &event) override;
 
 private:
-    void processQueuedTransactions();
+    // Java callbacks recorded as StoreEvents
+    enum EventType {
+        ConnectedChangedEvent,
+        ProductRegisteredEvent,
+        ProductRegistrationFailedEvent,
+        PurchaseSucceededEvent,
+        PurchasePendingEvent,
+        PurchaseRestoredEvent,
+        PurchaseFailedEvent,
+        PurchaseConsumedEvent,
+        PurchaseConsumeFailedEvent,
+        RestoreSucceededEvent,
+        RestoreFailedEvent
+    };
+
+    static QString fromJavaString(JNIEnv * env, jstring string);
+    static void postFromJava(StoreEvent event);
+    static void decodeStoreEvent(StoreEvent &event);
+
+    void handleProductRegistered(const StoreEvent &event);
+    void handleProductRegistrationFailed(const QString &productId, int billingResponseCode);
+    void handlePurchaseSucceeded(const Transaction &transaction);
+    void handlePurchasePending(const Transaction &transaction);
+    void handlePurchaseRestored(const Transaction &transaction);
     static PurchaseError mapBillingResponseToPurchaseError(int billingResponseCode);
     static QString getBillingResponseMessage(int billingResponseCode);
 
     // Queued transaction data
-    QList<QJsonObject> _queuedPurchaseSucceeded;
-    QList<QJsonObject> _queuedPurchaseRestored;
-    QList<QJsonObject> _queuedPurchasePending;
+    QList<Transaction> _queuedPurchaseSucceeded;
+    QList<Transaction> _queuedPurchaseRestored;
+    QList<Transaction> _queuedPurchasePending;
 
     static GooglePlayStoreBackend * s_currentInstance;
     QJniObject * _googlePlayBillingJavaClass = nullptr;
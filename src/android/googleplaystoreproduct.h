@@ -1,7 +1,6 @@
 #ifndef GOOGLEPLAYSTOREPRODUCT_H
 #define GOOGLEPLAYSTOREPRODUCT_H
 
-#include <QJsonObject>
 #include <qt6purchasing/abstractproduct.h>
 
 class GooglePlayStoreBackend;
@@ -9,19 +8,9 @@ class GooglePlayStoreBackend;
 class GooglePlayStoreProduct : public AbstractProduct
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(Product)
 
 public:
     GooglePlayStoreProduct(QObject * parent = nullptr);
-
-    QJsonObject json() const { return _json; }
-    void setJson(QJsonObject json);
-
-private:
-    QJsonObject _json;
-
-signals:
-    void jsonChanged();
 };
 
 #endif // GOOGLEPLAYSTOREPRODUCT_H
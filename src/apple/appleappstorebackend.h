@@ -4,25 +4,22 @@
 #include <qt6purchasing/abstractstorebackend.h>
 
 Q_FORWARD_DECLARE_OBJC_CLASS(InAppPurchaseManager);
+Q_FORWARD_DECLARE_OBJC_CLASS(SKProduct);
 
 class AppleAppStoreBackend : public AbstractStoreBackend
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(Store)
 
 public:
     AppleAppStoreBackend(QObject * parent = nullptr);
     ~AppleAppStoreBackend();
 
     void startConnection() override;
-    void registerProduct(AbstractProduct * product) override;
+    void registerProduct(const QString &identifier) override;
     void purchaseProduct(AbstractProduct * product) override;
     void consumePurchase(Transaction transaction) override;
     bool canMakePurchases() const override;
 
-    // Transaction processing control
-    void enableProcessing() override;
-
     // Static early initialization from main.cpp (before any instances exist)
     static void initializeEarlyTransactionQueue();
 
@@ -30,12 +27,33 @@ public:
     InAppPurchaseManager * iapManager() const { return _iapManager; }
     int restoredPurchasesCount() const { return _restoredPurchasesCount; }
 
+    // StoreKit callbacks recorded as StoreEvents
+    enum EventType {
+        ProductQuerySucceededEvent,
+        ProductQueryFailedEvent,
+        PurchaseSucceededEvent,
+        PurchaseFailedEvent,
+        PurchaseRestoredEvent,
+        PurchasePendingEvent,
+        RestoreSucceededEvent,
+        RestoreFailedEvent
+    };
+
+    // Internal access for TransactionObserver and InAppPurchaseManager; safe from any thread
+    void postEvent(StoreEvent event) { postStoreEvent(std::move(event)); }
+
     static AppleAppStoreBackend * s_currentInstance;
 
 protected:
     void restorePurchasesImpl() override;
+    void processQueuedTransactions() override;
+    AbstractProduct * createProduct(ProductCatalog::Handle handle) override;
+    void handleStoreEvent(const StoreEvent &event) override;
 
 private:
+    void productQuerySucceeded(SKProduct * skProduct);
+    void productQueryFailed(const QString &identifier);
+
     InAppPurchaseManager * _iapManager = nullptr;
     int _restoredPurchasesCount = 0;
 };
@@ -84,6 +84,23 @@ static QString getStoreKitErrorMessage(int errorCode)
     }
 }
 
+// Creating an NSNumberFormatter is expensive; products mostly share a handful of price locales
+static NSNumberFormatter * priceFormatterForLocale(NSLocale * locale)
+{
+    static NSMutableDictionary<NSString *, NSNumberFormatter *> * formatters =
+        [[NSMutableDictionary<NSString *, NSNumberFormatter *> alloc] init];
+
+    NSNumberFormatter * numberFormatter = [formatters objectForKey:locale.localeIdentifier];
+    if (numberFormatter == nil) {
+        numberFormatter = [[NSNumberFormatter alloc] init];
+        [numberFormatter setFormatterBehavior:NSNumberFormatterBehavior10_4];
+        [numberFormatter setNumberStyle:NSNumberFormatterCurrencyStyle];
+        [numberFormatter setLocale:locale];
+        [formatters setObject:numberFormatter forKey:locale.localeIdentifier];
+    }
+    return numberFormatter;
+}
+
 AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 
 // Observer that handles all transactions for the app lifetime
@@ -132,22 +149,22 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 - (void)paymentQueue:(SKPaymentQueue *)queue updatedTransactions:(NSArray<SKPaymentTransaction *> *)transactions
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
-    qDebug() << "TransactionObserver received" << transactions.count << "transactions";
+    qCDebug(lcStore) << "TransactionObserver received" << transactions.count << "transactions";
 
     if (!backend) {
-        qDebug() << "No backend instance available - queueing transactions";
+        qCDebug(lcStore) << "No backend instance available - queueing transactions";
         [queuedTransactions addObjectsFromArray:transactions];
         return;
     }
 
     if (!backend->processingEnabled()) {
-        qDebug() << "Processing not enabled - queueing transactions";
+        qCDebug(lcStore) << "Processing not enabled - queueing transactions";
         [queuedTransactions addObjectsFromArray:transactions];
         return;
     }
 
     // Process transactions immediately
-    qDebug() << "Processing transactions immediately";
+    qCDebug(lcStore) << "Processing transactions immediately";
     [self processTransactions:transactions];
 }
 
@@ -155,44 +172,44 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
 
-    qDebug() << "iOS: processing" << skTransactions.count << "transactions";
+    qCDebug(lcStore) << "iOS: processing" << skTransactions.count << "transactions";
     for (SKPaymentTransaction * skTransaction in skTransactions) {
-        qDebug() << "iOS: Processing transaction ID:" << QString::fromNSString(skTransaction.transactionIdentifier)
-                 << "state:" << skTransaction.transactionState
-                 << "product:" << QString::fromNSString(skTransaction.payment.productIdentifier);
+        qCDebug(lcStore) << "iOS: Processing transaction ID:"
+                         << QString::fromNSString(skTransaction.transactionIdentifier)
+                         << "state:" << skTransaction.transactionState
+                         << "product:" << QString::fromNSString(skTransaction.payment.productIdentifier);
         switch (static_cast<AppleAppStoreTransactionState::State>(skTransaction.transactionState)) {
         case AppleAppStoreTransactionState::Purchasing: {
-            qDebug() << "iOS: Transaction moving to Purchasing state (user presented with iOS payment dialog)";
+            qCDebug(lcStore) << "iOS: Transaction moving to Purchasing state (user presented with iOS payment dialog)";
         } break;
         case AppleAppStoreTransactionState::Purchased: {
-            auto transaction = transactionFromSKTransaction(skTransaction);
-            QMetaObject::invokeMethod(
-                backend, "purchaseSucceeded", Qt::AutoConnection, Q_ARG(Transaction, transaction)
-            );
+            StoreEvent event;
+            event.type = AppleAppStoreBackend::PurchaseSucceededEvent;
+            event.transaction = transactionFromSKTransaction(skTransaction);
+            backend->postEvent(std::move(event));
         } break;
         case AppleAppStoreTransactionState::Failed: {
             // Extract product ID from the transaction
-            QString productId = QString::fromNSString(skTransaction.payment.productIdentifier);
             int errorCode = skTransaction.error.code;
-            AbstractStoreBackend::PurchaseError error = mapStoreKitErrorToPurchaseError(errorCode);
-            QString message = getStoreKitErrorMessage(errorCode);
-            QMetaObject::invokeMethod(
-                backend,
-                "purchaseFailed",
-                Qt::AutoConnection,
-                Q_ARG(QString, productId),
-                Q_ARG(int, static_cast<int>(error)),
-                Q_ARG(int, errorCode),
-                Q_ARG(QString, message)
-            );
+            StoreEvent event;
+            event.type = AppleAppStoreBackend::PurchaseFailedEvent;
+            event.text = QString::fromNSString(skTransaction.payment.productIdentifier);
+            event.code = static_cast<int>(mapStoreKitErrorToPurchaseError(errorCode));
+            event.platformCode = errorCode;
+            event.message = getStoreKitErrorMessage(errorCode);
+            backend->postEvent(std::move(event));
         } break;
         case AppleAppStoreTransactionState::Restored: {
-            auto transaction = transactionFromSKTransaction(skTransaction);
-            QMetaObject::invokeMethod(backend, "purchaseRestored", Qt::AutoConnection, Q_ARG(Transaction, transaction));
+            StoreEvent event;
+            event.type = AppleAppStoreBackend::PurchaseRestoredEvent;
+            event.transaction = transactionFromSKTransaction(skTransaction);
+            backend->postEvent(std::move(event));
         } break;
         case AppleAppStoreTransactionState::Deferred: {
-            auto transaction = transactionFromSKTransaction(skTransaction);
-            QMetaObject::invokeMethod(backend, "purchasePending", Qt::AutoConnection, Q_ARG(Transaction, transaction));
+            StoreEvent event;
+            event.type = AppleAppStoreBackend::PurchasePendingEvent;
+            event.transaction = transactionFromSKTransaction(skTransaction);
+            backend->postEvent(std::move(event));
         } break;
         }
     }
@@ -202,16 +219,16 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
     if (!backend) {
-        qDebug() << "TransactionObserver: No backend available for processing queued transactions";
+        qCDebug(lcStore) << "TransactionObserver: No backend available for processing queued transactions";
         return;
     }
 
     if (queuedTransactions.count > 0) {
-        qDebug() << "TransactionObserver: Processing" << queuedTransactions.count << "queued transactions";
+        qCDebug(lcStore) << "TransactionObserver: Processing" << queuedTransactions.count << "queued transactions";
         [self processTransactions:queuedTransactions];
         [queuedTransactions removeAllObjects];
     } else {
-        qDebug() << "TransactionObserver: No queued transactions to process";
+        qCDebug(lcStore) << "TransactionObserver: No queued transactions to process";
     }
 }
 
@@ -219,46 +236,44 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
     if (!backend) {
-        qWarning() << "TransactionObserver: Restore failed but no backend available";
+        qCWarning(lcStore) << "TransactionObserver: Restore failed but no backend available";
         return;
     }
 
-    qDebug() << "iOS: Restore purchases failed with error code:" << error.code;
+    qCDebug(lcStore) << "iOS: Restore purchases failed with error code:" << error.code;
 
     int errorCode = error.code;
-    AbstractStoreBackend::PurchaseError mappedError = mapStoreKitErrorToPurchaseError(errorCode);
-    QString message = getStoreKitErrorMessage(errorCode);
-
-    QMetaObject::invokeMethod(
-        backend,
-        "restorePurchasesFailed",
-        Qt::AutoConnection,
-        Q_ARG(int, static_cast<int>(mappedError)),
-        Q_ARG(int, errorCode),
-        Q_ARG(QString, message)
-    );
+    StoreEvent event;
+    event.type = AppleAppStoreBackend::RestoreFailedEvent;
+    event.code = static_cast<int>(mapStoreKitErrorToPurchaseError(errorCode));
+    event.platformCode = errorCode;
+    event.message = getStoreKitErrorMessage(errorCode);
+    backend->postEvent(std::move(event));
 }
 
 - (void)paymentQueueRestoreCompletedTransactionsFinished:(SKPaymentQueue *)queue
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
     if (!backend) {
-        qWarning() << "TransactionObserver: Restore completed but no backend available";
+        qCWarning(lcStore) << "TransactionObserver: Restore completed but no backend available";
         return;
     }
 
-    int count = backend->restoredPurchasesCount();
-    qDebug() << "iOS: Restore purchases completed successfully. Count:" << count;
-
-    QMetaObject::invokeMethod(backend, "restorePurchasesSucceeded", Qt::AutoConnection, Q_ARG(int, count));
+    // Counted when handled, after the restored transactions queued ahead of it
+    StoreEvent event;
+    event.type = AppleAppStoreBackend::RestoreSucceededEvent;
+    backend->postEvent(std::move(event));
 }
 
 @end
 
-@interface InAppPurchaseManager : NSObject <SKProductsRequestDelegate>
+@interface InAppPurchaseManager : NSObject <SKProductsRequestDelegate> {
+    NSMutableDictionary<NSString *, SKProduct *> * products;
+}
 
 - (id)init;
 - (void)requestProductData:(NSString *)identifier;
+- (SKProduct *)productForIdentifier:(NSString *)identifier;
 
 @end
 
@@ -267,11 +282,20 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 - (id)init
 {
     if (self = [super init]) {
-        qDebug() << "InAppPurchaseManager: Initialized for product queries only";
+        products = [[NSMutableDictionary<NSString *, SKProduct *> alloc] init];
+        qCDebug(lcStore) << "InAppPurchaseManager: Initialized for product queries only";
     }
     return self;
 }
 
+- (SKProduct *)productForIdentifier:(NSString *)identifier
+{
+    // Filled in on StoreKit's callback thread, read on the GUI thread
+    @synchronized(products) {
+        return [products objectForKey:identifier];
+    }
+}
+
 - (void)dealloc
 {
     // No transaction observer to remove
@@ -279,7 +303,7 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 
 - (void)requestProductData:(NSString *)identifier
 {
-    qDebug() << "StoreKit: Requesting product data for identifier:" << QString::fromNSString(identifier);
+    qCDebug(lcStore) << "StoreKit: Requesting product data for identifier:" << QString::fromNSString(identifier);
 
     NSSet<NSString *> * productId = [NSSet<NSString *> setWithObject:identifier];
     SKProductsRequest * productsRequest = [[SKProductsRequest alloc] initWithProductIdentifiers:productId];
@@ -287,9 +311,9 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 
 // Check if we're using StoreKit testing
 #if TARGET_OS_SIMULATOR
-    qDebug() << "StoreKit: Running in iOS Simulator";
+    qCDebug(lcStore) << "StoreKit: Running in iOS Simulator";
 #else
-    qDebug() << "StoreKit: Running on physical device";
+    qCDebug(lcStore) << "StoreKit: Running on physical device";
 #endif
 
     [productsRequest start];
@@ -300,57 +324,40 @@ AppleAppStoreBackend * AppleAppStoreBackend::s_currentInstance = nullptr;
 {
     AppleAppStoreBackend * backend = AppleAppStoreBackend::s_currentInstance;
     if (!backend) {
-        qCritical() << "Apple Store product callback received but backend instance is null";
+        qCCritical(lcStore) << "Apple Store product callback received but backend instance is null";
         return;
     }
 
-    qDebug() << "StoreKit: Received product response; num valid products:" << response.products.count
-             << "; num invalid product identifiers:" << response.invalidProductIdentifiers.count;
+    qCDebug(lcStore) << "StoreKit: Received product response; num valid products:" << response.products.count
+                     << "; num invalid product identifiers:" << response.invalidProductIdentifiers.count;
     if (response.invalidProductIdentifiers.count > 0) {
         for (NSString * invalidId in response.invalidProductIdentifiers) {
-            qDebug() << "StoreKit: Invalid product ID:" << QString::fromNSString(invalidId);
+            qCDebug(lcStore) << "StoreKit: Invalid product ID:" << QString::fromNSString(invalidId);
         }
     }
     if (response.products.count > 0) {
         for (SKProduct * product in response.products) {
-            qDebug() << "StoreKit: Valid product found:" << QString::fromNSString(product.productIdentifier);
+            qCDebug(lcStore) << "StoreKit: Valid product found:" << QString::fromNSString(product.productIdentifier);
         }
     }
 
     NSArray<SKProduct *> * skProducts = response.products;
     SKProduct * skProduct = [skProducts count] == 1 ? [skProducts firstObject] : nil;
 
+    StoreEvent event;
     if (skProduct == nil) {
         //Invalid product ID
-        NSString * invalidId = [response.invalidProductIdentifiers firstObject];
-        if (backend->product(QString::fromNSString(invalidId)))
-            backend->product(QString::fromNSString(invalidId))->setStatus(AbstractProduct::Unknown);
+        event.type = AppleAppStoreBackend::ProductQueryFailedEvent;
+        event.text = QString::fromNSString([response.invalidProductIdentifiers firstObject]);
     } else {
         //Valid product query
-        AppleAppStoreProduct * product = reinterpret_cast<AppleAppStoreProduct *>(
-            backend->product(QString::fromNSString(skProduct.productIdentifier))
-        );
-
-        if (product) {
-            // formatting price string
-            NSNumberFormatter * numberFormatter = [[NSNumberFormatter alloc] init];
-            [numberFormatter setFormatterBehavior:NSNumberFormatterBehavior10_4];
-            [numberFormatter setNumberStyle:NSNumberFormatterCurrencyStyle];
-            [numberFormatter setLocale:skProduct.priceLocale];
-            NSString * localizedPrice = [numberFormatter stringFromNumber:skProduct.price];
-
-            product->setNativeProduct(skProduct);
-            product->setDescription(QString::fromNSString(skProduct.localizedDescription));
-            product->setPrice(QString::fromNSString(localizedPrice));
-            product->setTitle(QString::fromNSString(skProduct.localizedTitle));
-            product->setStatus(AbstractProduct::Registered);
-
-            QMetaObject::invokeMethod(
-                backend, "productRegistered", Qt::AutoConnection, Q_ARG(AbstractProduct *, product)
-            );
-        } else {
+        @synchronized(products) {
+            [products setObject:skProduct forKey:skProduct.productIdentifier];
         }
+        event.type = AppleAppStoreBackend::ProductQuerySucceededEvent;
+        event.text = QString::fromNSString(skProduct.productIdentifier);
     }
+    backend->postEvent(std::move(event));
 }
 
 @end
@@ -377,7 +384,7 @@ AppleAppStoreBackend::~AppleAppStoreBackend()
 // Static version for early initialization from main.cpp
 void AppleAppStoreBackend::initializeEarlyTransactionQueue()
 {
-    qDebug() << "iOS IAP: Adding transaction observer early to catch pending transactions";
+    qCDebug(lcStore) << "iOS IAP: Adding transaction observer early to catch pending transactions";
     [[SKPaymentQueue defaultQueue] addTransactionObserver:[TransactionObserver shared]];
 }
 
@@ -388,14 +395,86 @@ void AppleAppStoreBackend::startConnection()
     setCanMakePurchases(canMakePurchases());
 }
 
-void AppleAppStoreBackend::registerProduct(AbstractProduct * product)
+void AppleAppStoreBackend::registerProduct(const QString &identifier)
+{
+    [_iapManager requestProductData:(identifier.toNSString())];
+}
+
+AbstractProduct * AppleAppStoreBackend::createProduct(ProductCatalog::Handle handle)
+{
+    auto * product = new AppleAppStoreProduct();
+    product->setNativeProduct([_iapManager productForIdentifier:_catalog.identifier(handle).toNSString()]);
+    return product;
+}
+
+void AppleAppStoreBackend::handleStoreEvent(const StoreEvent &event)
+{
+    switch (static_cast<EventType>(event.type)) {
+    case ProductQuerySucceededEvent:
+        if (SKProduct * skProduct = [_iapManager productForIdentifier:event.text.toNSString()])
+            productQuerySucceeded(skProduct);
+        break;
+    case ProductQueryFailedEvent:
+        productQueryFailed(event.text);
+        break;
+    case PurchaseSucceededEvent:
+        emit purchaseSucceeded(event.transaction);
+        break;
+    case PurchaseFailedEvent:
+        emit purchaseFailed(event.text, event.code, event.platformCode, event.message);
+        break;
+    case PurchaseRestoredEvent:
+        emit purchaseRestored(event.transaction);
+        break;
+    case PurchasePendingEvent:
+        emit purchasePending(event.transaction);
+        break;
+    case RestoreSucceededEvent:
+        qCDebug(lcStore) << "iOS: Restore purchases completed successfully. Count:" << _restoredPurchasesCount;
+        emit restorePurchasesSucceeded(_restoredPurchasesCount);
+        break;
+    case RestoreFailedEvent:
+        emit restorePurchasesFailed(event.code, event.platformCode, event.message);
+        break;
+    }
+}
+
+void AppleAppStoreBackend::productQuerySucceeded(SKProduct * skProduct)
+{
+    const ProductCatalog::Handle handle = _catalog.handle(QString::fromNSString(skProduct.productIdentifier));
+    if (handle < 0)
+        return;
+
+    // formatting price string
+    NSString * localizedPrice = [priceFormatterForLocale(skProduct.priceLocale) stringFromNumber:skProduct.price];
+
+    AppleAppStoreProduct * product = reinterpret_cast<AppleAppStoreProduct *>(_catalog.facade(handle));
+    if (product)
+        product->setNativeProduct(skProduct);
+
+    ProductStoreData data;
+    data.title = QString::fromNSString(skProduct.localizedTitle);
+    data.description = QString::fromNSString(skProduct.localizedDescription);
+    data.price = QString::fromNSString(localizedPrice);
+    data.priceMicros = [[skProduct.price decimalNumberByMultiplyingByPowerOf10:6] longLongValue];
+    data.currencyCode = QString::fromNSString(skProduct.priceLocale.currencyCode);
+    const bool refresh = isRefreshing(handle);
+    applyStoreData(handle, data, AbstractProduct::Registered);
+
+    if (product && !refresh)
+        emit productRegistered(product);
+}
+
+void AppleAppStoreBackend::productQueryFailed(const QString &identifier)
 {
-    [_iapManager requestProductData:(product->identifier().toNSString())];
+    const ProductCatalog::Handle handle = _catalog.handle(identifier);
+    if (handle >= 0)
+        setProductStatus(handle, AbstractProduct::Unknown);
 }
 
 void AppleAppStoreBackend::purchaseProduct(AbstractProduct * product)
 {
-    SKProduct * skProduct = reinterpret_cast<AppleAppStoreProduct *>(product)->nativeProduct();
+    SKProduct * skProduct = [_iapManager productForIdentifier:product->identifier().toNSString()];
 
     SKPayment * payment = [SKPayment paymentWithProduct:skProduct];
     [[SKPaymentQueue defaultQueue] addPayment:payment];
@@ -403,7 +482,7 @@ void AppleAppStoreBackend::purchaseProduct(AbstractProduct * product)
 
 void AppleAppStoreBackend::consumePurchase(Transaction transaction)
 {
-    qDebug() << "iOS: consumePurchase called for" << transaction.orderId;
+    qCDebug(lcStore) << "iOS: consumePurchase called for" << transaction.orderId;
 
     // Look up the SKPaymentTransaction using orderId (transactionIdentifier)
     NSString * identifier = transaction.orderId.toNSString();
@@ -419,14 +498,14 @@ void AppleAppStoreBackend::consumePurchase(Transaction transaction)
     }
 
     if (!found) {
-        qWarning() << "iOS: Transaction not found in queue for orderId:" << transaction.orderId;
+        qCWarning(lcStore) << "iOS: Transaction not found in queue for orderId:" << transaction.orderId;
         emit consumePurchaseFailed(transaction);
     }
 }
 
 void AppleAppStoreBackend::restorePurchasesImpl()
 {
-    qDebug() << "iOS restorePurchasesImpl() called - triggering SKPaymentQueue.restoreCompletedTransactions";
+    qCDebug(lcStore) << "iOS restorePurchasesImpl() called - triggering SKPaymentQueue.restoreCompletedTransactions";
     _restoredPurchasesCount = 0;
     [[SKPaymentQueue defaultQueue] restoreCompletedTransactions];
 }
@@ -436,13 +515,9 @@ bool AppleAppStoreBackend::canMakePurchases() const
     return isConnected() && [SKPaymentQueue canMakePayments];
 }
 
-void AppleAppStoreBackend::enableProcessing()
+void AppleAppStoreBackend::processQueuedTransactions()
 {
-    if (processingEnabled())
-        return;
-
-    AbstractStoreBackend::enableProcessing();
-
-    qDebug() << "iOS: Processing enabled - processing queued transactions";
+    // Posted as events, handled ahead of the store's drained marker
+    qCDebug(lcStore) << "iOS: Processing enabled - processing queued transactions";
     [[TransactionObserver shared] processQueuedTransactions];
 }
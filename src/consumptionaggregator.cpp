@@ -0,0 +1,42 @@
+#include <qt6purchasing/consumptionaggregator.h>
+
+#include <utility>
+
+ConsumptionAggregator::ConsumptionAggregator(Handler handler) : _handler(std::move(handler))
+{
+    _timer.setSingleShot(true);
+    _timer.setInterval(0);
+    QObject::connect(&_timer, &QTimer::timeout, [this]() { flush(); });
+}
+
+void ConsumptionAggregator::setWindow(int window)
+{
+    _timer.setInterval(qMax(0, window));
+    if (window <= 0)
+        flush();
+}
+
+void ConsumptionAggregator::add(const Transaction &transaction)
+{
+    auto it = _pending.find(transaction.productId);
+    if (it == _pending.end()) {
+        _productOrder.append(transaction.productId);
+        it = _pending.insert(transaction.productId, {});
+    }
+    it->append(transaction);
+
+    // The window opens with the first consumption, so none waits longer than the window
+    if (!_timer.isActive())
+        _timer.start();
+}
+
+void ConsumptionAggregator::flush()
+{
+    _timer.stop();
+
+    // The handler may add more; those wait for the next window
+    const QList<QString> productOrder = std::exchange(_productOrder, {});
+    const QHash<QString, QList<Transaction>> pending = std::exchange(_pending, {});
+    for (const QString &productId : productOrder)
+        _handler(pending.value(productId));
+}
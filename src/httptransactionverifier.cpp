@@ -0,0 +1,149 @@
+#include <qt6purchasing/httptransactionverifier.h>
+#include <qt6purchasing/storelogging.h>
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+HttpTransactionVerifier::HttpTransactionVerifier(QObject * parent) : TransactionVerifier(parent)
+{
+    // Collect the transactions of a burst (e.g. several pending purchases on startup) into one request
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(50);
+    connect(&_batchTimer, &QTimer::timeout, this, &HttpTransactionVerifier::sendBatches);
+}
+
+void HttpTransactionVerifier::setEndpoint(const QUrl &endpoint)
+{
+    if (_endpoint == endpoint)
+        return;
+
+    _endpoint = endpoint;
+    emit endpointChanged();
+
+    // Open the connection now so the first verification does not pay for the handshake
+    if (_endpoint.scheme() == "https")
+        _network.connectToHostEncrypted(_endpoint.host(), _endpoint.port(443));
+    else if (_endpoint.isValid())
+        _network.connectToHost(_endpoint.host(), _endpoint.port(80));
+}
+
+void HttpTransactionVerifier::setHeaders(const QVariantMap &headers)
+{
+    if (_headers == headers)
+        return;
+    _headers = headers;
+    emit headersChanged();
+}
+
+void HttpTransactionVerifier::setBatchSize(int batchSize)
+{
+    batchSize = qMax(1, batchSize);
+    if (_batchSize == batchSize)
+        return;
+    _batchSize = batchSize;
+    emit batchSizeChanged();
+}
+
+void HttpTransactionVerifier::setBatchDelay(int batchDelay)
+{
+    if (_batchTimer.interval() == batchDelay)
+        return;
+    _batchTimer.setInterval(qMax(0, batchDelay));
+    emit batchDelayChanged();
+}
+
+void HttpTransactionVerifier::setMaxInFlight(int maxInFlight)
+{
+    maxInFlight = qMax(1, maxInFlight);
+    if (_maxInFlight == maxInFlight)
+        return;
+    _maxInFlight = maxInFlight;
+    emit maxInFlightChanged();
+    sendBatches();
+}
+
+void HttpTransactionVerifier::setTimeout(int timeout)
+{
+    if (_timeout == timeout)
+        return;
+    _timeout = timeout;
+    emit timeoutChanged();
+}
+
+void HttpTransactionVerifier::verify(const Transaction &transaction)
+{
+    if (!_endpoint.isValid()) {
+        qCWarning(lcStore) << "HttpTransactionVerifier: no endpoint set - cannot verify" << transaction.orderId;
+        emit verified(transaction, Error);
+        return;
+    }
+
+    _queue.append(transaction);
+
+    if (_queue.size() >= _batchSize)
+        sendBatches();
+    else if (!_batchTimer.isActive())
+        _batchTimer.start();
+}
+
+void HttpTransactionVerifier::sendBatches()
+{
+    _batchTimer.stop();
+
+    // Anything left over is sent as replies free up request slots
+    while (!_queue.isEmpty() && _inFlight < _maxInFlight) {
+        const QList<Transaction> batch = _queue.mid(0, _batchSize);
+        _queue.remove(0, batch.size());
+
+        QJsonArray transactions;
+        for (const Transaction &transaction : batch) {
+            QJsonObject entry;
+            entry["id"] = transaction.key();
+            entry["orderId"] = transaction.orderId;
+            entry["productId"] = transaction.productId;
+            if (!transaction.purchaseToken.isEmpty())
+                entry["purchaseToken"] = transaction.purchaseToken;
+            transactions.append(entry);
+        }
+        QJsonObject body;
+        body["transactions"] = transactions;
+
+        QNetworkRequest request(_endpoint);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        request.setTransferTimeout(_timeout);
+        for (auto it = _headers.constBegin(); it != _headers.constEnd(); ++it)
+            request.setRawHeader(it.key().toUtf8(), it.value().toString().toUtf8());
+
+        qCDebug(lcStore) << "HttpTransactionVerifier: verifying" << batch.size() << "transaction(s)";
+        QNetworkReply * reply = _network.post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+        ++_inFlight;
+        connect(reply, &QNetworkReply::finished, this, [this, reply, batch]() { handleReply(reply, batch); });
+    }
+}
+
+void HttpTransactionVerifier::handleReply(QNetworkReply * reply, const QList<Transaction> &batch)
+{
+    reply->deleteLater();
+    --_inFlight;
+
+    QHash<QString, Verdict> verdicts;
+    if (reply->error() == QNetworkReply::NoError) {
+        const QJsonArray results = QJsonDocument::fromJson(reply->readAll()).object().value("results").toArray();
+        for (const QJsonValue &result : results) {
+            const QJsonObject object = result.toObject();
+            verdicts.insert(object["id"].toString(), object["valid"].toBool() ? Valid : Invalid);
+        }
+    } else {
+        qCWarning(lcStore) << "HttpTransactionVerifier: request failed:" << reply->errorString();
+    }
+
+    // Transactions the server did not answer for have no verdict
+    for (const Transaction &transaction : batch)
+        emit verified(transaction, verdicts.value(transaction.key(), Error));
+
+    sendBatches();
+}
@@ -2,7 +2,6 @@
 #define ABSTRACTPRODUCT_H
 
 #include <QObject>
-#include <QQmlEngine>
 
 // Forward declaration for AbstractStoreBackend to avoid circular dependency
 class AbstractStoreBackend;
@@ -10,21 +9,40 @@ class AbstractStoreBackend;
 // Need full definition for Transaction due to signal parameters
 #include <qt6purchasing/transaction.h>
 
+// Product metadata reported by a store, applied to a product in one step
+struct ProductStoreData
+{
+    QString title;
+    QString description;
+    QString price;
+    qint64 priceMicros = -1; // -1 when the store reports no numeric price
+    QString currencyCode;    // ISO 4217
+
+    bool operator==(const ProductStoreData &other) const
+    {
+        return title == other.title && description == other.description && price == other.price
+               && priceMicros == other.priceMicros && currencyCode == other.currencyCode;
+    }
+    bool operator!=(const ProductStoreData &other) const { return !(*this == other); }
+};
+
 class AbstractProduct : public QObject
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(AbstractProduct)
-    QML_UNCREATABLE("AbstractProduct is an abstract base class")
 
     // writable properties
     Q_PROPERTY(QString identifier READ identifier WRITE setIdentifier NOTIFY identifierChanged REQUIRED)
     Q_PROPERTY(ProductType type READ productType WRITE setProductType NOTIFY productTypeChanged REQUIRED)
     Q_PROPERTY(QString microsoftStoreId READ microsoftStoreId WRITE setMicrosoftStoreId NOTIFY microsoftStoreIdChanged)
+    Q_PROPERTY(FinalizePolicy finalizePolicy READ finalizePolicy WRITE setFinalizePolicy NOTIFY finalizePolicyChanged)
     // read only properties
     Q_PROPERTY(ProductStatus status READ status NOTIFY statusChanged)
-    Q_PROPERTY(QString description READ description NOTIFY descriptionChanged)
-    Q_PROPERTY(QString price READ price NOTIFY priceChanged)
-    Q_PROPERTY(QString title READ title NOTIFY titleChanged)
+    // store data properties share one notification so bindings re-evaluate once per update
+    Q_PROPERTY(QString description READ description NOTIFY storeDataChanged)
+    Q_PROPERTY(QString price READ price NOTIFY storeDataChanged)
+    Q_PROPERTY(QString title READ title NOTIFY storeDataChanged)
+    Q_PROPERTY(qint64 priceMicros READ priceMicros NOTIFY storeDataChanged)
+    Q_PROPERTY(QString currencyCode READ currencyCode NOTIFY storeDataChanged)
 
 public:
     enum ProductType {
@@ -41,15 +59,30 @@ public:
         Unknown
     };
     Q_ENUM(ProductStatus)
+    enum FinalizePolicy {
+        StoreFinalizePolicy, // products only: use the store's policy
+        ManualFinalize,      // the app calls finalize()
+        AutoFinalize,        // finalized once all purchase handlers have returned
+        AcknowledgedFinalize // finalized once the app calls acknowledge()
+    };
+    Q_ENUM(FinalizePolicy)
+
+    ~AbstractProduct() override;
 
     ProductStatus status() const { return _status; }
     QString identifier() const { return _identifier; }
     QString description() const { return _description; }
     QString price() const { return _price; }
+    qint64 priceMicros() const { return _priceMicros; }
+    QString currencyCode() const { return _currencyCode; }
     ProductType productType() const { return _productType; }
     QString title() const { return _title; }
     QString microsoftStoreId() const { return _microsoftStoreId; }
+    FinalizePolicy finalizePolicy() const { return _finalizePolicy; }
+    ProductStoreData storeData() const { return {_title, _description, _price, _priceMicros, _currencyCode}; }
     bool isReadyForRegister() const { return _isReadyForRegister; }
+    // The store's own description of the product, as received at registration. Shared, not copied.
+    QByteArray platformPayload() const;
 
     void setIdentifier(const QString &value);
     void setProductType(ProductType type);
@@ -58,6 +91,8 @@ public:
     void setPrice(const QString &value);
     void setTitle(const QString &value);
     void setMicrosoftStoreId(const QString &value);
+    void setFinalizePolicy(FinalizePolicy policy);
+    void applyStoreData(const ProductStoreData &data, ProductStatus status);
 
     void registerInStore();
 
@@ -70,30 +105,46 @@ protected:
     QString _identifier = QString();
     QString _description = QString();
     QString _price = QString();
+    qint64 _priceMicros = -1;
+    QString _currencyCode = QString();
     ProductType _productType = ProductType::None;
     QString _title = QString();
     QString _microsoftStoreId = QString();
+    FinalizePolicy _finalizePolicy = FinalizePolicy::StoreFinalizePolicy;
 
 private:
+    friend class AbstractStoreBackend;
+
     AbstractStoreBackend * findStoreBackend() const;
     void updateIsReadyForRegister();
+    void updateCatalogEntry();
+    void notify(void (AbstractProduct::*signal)());
 
     bool _isReadyForRegister = false;
 
+    // Set by the store backend while this product is the facade of one of its catalog rows
+    AbstractStoreBackend * _store = nullptr;
+    qsizetype _catalogHandle = -1;
+
 signals:
     void statusChanged();
     void identifierChanged();
+    void storeDataChanged();
+    // Deprecated: emitted alongside storeDataChanged, and to be removed in the next release
+    void titleChanged();
     void descriptionChanged();
     void priceChanged();
     void productTypeChanged();
-    void titleChanged();
     void microsoftStoreIdChanged();
+    void finalizePolicyChanged();
     void isReadyForRegisterChanged();
 
     void purchaseSucceeded(Transaction transaction);
     void purchasePending(Transaction transaction);
     void purchaseFailed(int error, int platformCode, const QString &message);
     void purchaseRestored(Transaction transaction);
+    // Incremental restore only: a restore no longer reported this unlockable, e.g. after a refund
+    void purchaseRevoked();
     void consumePurchaseSucceeded(Transaction transaction);
     void consumePurchaseFailed(Transaction transaction);
 };
@@ -1,22 +1,37 @@
 #ifndef ABSTRACTSTOREBACKEND_H
 #define ABSTRACTSTOREBACKEND_H
 
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QObject>
-#include <QQmlEngine>
-#include <QQmlListProperty>
-
-// Forward declaration for AbstractProduct to avoid circular dependency
-class AbstractProduct;
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
 
 // Need full definition for Transaction for member access and QML integration
 #include <qt6purchasing/transaction.h>
 
+// Product data for the whole catalog lives here; AbstractProduct instances are facades over it
+#include <qt6purchasing/productcatalog.h>
+#include <qt6purchasing/productsearchindex.h>
+#include <qt6purchasing/consumptionaggregator.h>
+#include <qt6purchasing/notificationcoalescer.h>
+#include <qt6purchasing/priceformatter.h>
+#include <qt6purchasing/ratelimiter.h>
+#include <qt6purchasing/startupmilestones.h>
+#include <qt6purchasing/startuporchestrator.h>
+#include <qt6purchasing/storeeventqueue.h>
+#include <qt6purchasing/storelogging.h>
+#include <qt6purchasing/storesnapshot.h>
+#include <qt6purchasing/transactionhistory.h>
+#include <qt6purchasing/transactionverifier.h>
+
 class AbstractStoreBackend : public QObject
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(AbstractStoreBackend)
-    QML_UNCREATABLE("AbstractStoreBackend is an abstract base class")
 
 public:
     enum class PurchaseError {
@@ -31,36 +46,173 @@ public:
         DeveloperError,
         PaymentInvalid,
         NotAllowed,
-        UnknownError
+        UnknownError,
+        NotRecorded // replay only: the recording holds no outcome for the purchase
     };
     Q_ENUM(PurchaseError)
 
-    Q_PROPERTY(QQmlListProperty<AbstractProduct> productsQml READ productsQml NOTIFY productsChanged)
-    Q_CLASSINFO("DefaultProperty", "productsQml")
+    // Outbound calls to the platform store, rate limited per kind
+    enum RequestKind {
+        RegisterRequest,
+        PurchaseRequest,
+        ConsumeRequest,
+        RestoreRequest
+    };
+    Q_ENUM(RequestKind)
+
     Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged FINAL)
     Q_PROPERTY(bool canMakePurchases READ canMakePurchases NOTIFY canMakePurchasesChanged FINAL)
     Q_PROPERTY(bool processingEnabled READ processingEnabled NOTIFY processingEnabledChanged FINAL)
     Q_PROPERTY(bool isRestoringPurchases READ isRestoringPurchases NOTIFY isRestoringPurchasesChanged FINAL)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged FINAL)
+    Q_PROPERTY(StartupMilestones startupMilestones READ startupMilestones NOTIFY startupMilestonesChanged FINAL)
+    Q_PROPERTY(bool incrementalRestore READ incrementalRestore WRITE setIncrementalRestore NOTIFY
+                   incrementalRestoreChanged FINAL)
+    Q_PROPERTY(QStringList ownedProducts READ ownedProducts WRITE setOwnedProducts NOTIFY ownedProductsChanged FINAL)
+    Q_PROPERTY(int restoreResultTtl READ restoreResultTtl WRITE setRestoreResultTtl NOTIFY restoreResultTtlChanged
+                   FINAL)
+    Q_PROPERTY(bool restoreOnConnect READ restoreOnConnect WRITE setRestoreOnConnect NOTIFY restoreOnConnectChanged
+                   FINAL)
+    Q_PROPERTY(QString historyPath READ historyPath WRITE setHistoryPath NOTIFY historyPathChanged FINAL)
+    Q_PROPERTY(TransactionVerifier * verifier READ verifier WRITE setVerifier NOTIFY verifierChanged FINAL)
+    Q_PROPERTY(int maxConcurrentFinalizations READ maxConcurrentFinalizations WRITE setMaxConcurrentFinalizations NOTIFY
+                   maxConcurrentFinalizationsChanged FINAL)
+    Q_PROPERTY(int finalizeTimeout READ finalizeTimeout WRITE setFinalizeTimeout NOTIFY finalizeTimeoutChanged FINAL)
+    Q_PROPERTY(int consumptionWindow READ consumptionWindow WRITE setConsumptionWindow NOTIFY consumptionWindowChanged
+                   FINAL)
+    Q_PROPERTY(int pendingIntentTimeout READ pendingIntentTimeout WRITE setPendingIntentTimeout NOTIFY
+                   pendingIntentTimeoutChanged FINAL)
+    Q_PROPERTY(AbstractProduct::FinalizePolicy finalizePolicy READ finalizePolicy WRITE setFinalizePolicy NOTIFY
+                   finalizePolicyChanged FINAL)
+    Q_PROPERTY(int maxMetadataAge READ maxMetadataAge WRITE setMaxMetadataAge NOTIFY maxMetadataAgeChanged FINAL)
+    Q_PROPERTY(QString searchQuery READ searchQuery WRITE setSearchQuery NOTIFY searchQueryChanged FINAL)
+    Q_PROPERTY(QList<AbstractProduct *> searchResults READ searchResults NOTIFY searchResultsChanged FINAL)
+    Q_PROPERTY(QString snapshotPath READ snapshotPath WRITE setSnapshotPath NOTIFY snapshotPathChanged FINAL)
+    Q_PROPERTY(bool decodeStoreEventsInBackground READ decodeStoreEventsInBackground WRITE
+                   setDecodeStoreEventsInBackground NOTIFY decodeStoreEventsInBackgroundChanged FINAL)
+    Q_PROPERTY(int maxQueuedRequests READ maxQueuedRequests WRITE setMaxQueuedRequests NOTIFY
+                   maxQueuedRequestsChanged FINAL)
+    Q_PROPERTY(bool coalesceNotifications READ coalesceNotifications WRITE setCoalesceNotifications NOTIFY
+                   coalesceNotificationsChanged FINAL)
 
 public:
-    QQmlListProperty<AbstractProduct> productsQml();
-    QList<AbstractProduct *> products() { return _products; }
+    ~AbstractStoreBackend() override;
+
+    QList<AbstractProduct *> products();
     AbstractProduct * product(const QString &identifier);
+    AbstractProduct * productForHandle(ProductCatalog::Handle handle);
+    const ProductCatalog &catalog() const { return _catalog; }
+    const ProductSearchIndex &searchIndex() const { return _searchIndex; }
+    // Products whose title or description match the query, best match first
+    Q_INVOKABLE QList<AbstractProduct *> searchProducts(const QString &query);
+    // The product list filtered by searchQuery; every product while the query is empty
+    QString searchQuery() const { return _searchQuery; }
+    void setSearchQuery(const QString &searchQuery);
+    QList<AbstractProduct *> searchResults();
     bool isConnected() const { return _connected; }
     virtual bool canMakePurchases() const = 0;
     bool processingEnabled() const { return _processingEnabled; }
     bool isRestoringPurchases() const { return _isRestoringPurchases; }
+    // Connected, with the catalog registered and the startup restore (if any) finished
+    bool isReady() const { return _startup.isFinished(); }
+    // Logged once, at info level, when every milestone has been reached
+    StartupMilestones startupMilestones() const { return _milestones; }
+    // Deliver a restored unlockable to its product only when it was not already known to be owned,
+    // and report unlockables a restore no longer includes as revoked
+    bool incrementalRestore() const { return _incrementalRestore; }
+    void setIncrementalRestore(bool incrementalRestore);
+    // Unlockables known to be owned; set it from saved state to carry it across launches
+    QStringList ownedProducts() const { return QStringList(_ownedProducts.cbegin(), _ownedProducts.cend()); }
+    void setOwnedProducts(const QStringList &ownedProducts);
+    // A restore requested within this many milliseconds of a successful one reports that result again
+    // without contacting the store; 0 disables
+    int restoreResultTtl() const { return _restoreResultTtl; }
+    void setRestoreResultTtl(int restoreResultTtl);
+    // Restore purchases whenever the store connects; at startup this overlaps product registration
+    bool restoreOnConnect() const { return _restoreOnConnect; }
+    void setRestoreOnConnect(bool restoreOnConnect);
+    QString historyPath() const { return _history.directory(); }
+    void setHistoryPath(const QString &historyPath);
+    TransactionHistory &history() { return _history; }
+    // Registered products whose store data is older than this many milliseconds are queried again in
+    // the background, and on reconnecting; 0 disables
+    int maxMetadataAge() const { return _maxMetadataAge; }
+    void setMaxMetadataAge(int maxMetadataAge);
+    QString snapshotPath() const { return _snapshotPath; }
+    void setSnapshotPath(const QString &snapshotPath);
+    TransactionVerifier * verifier() const { return _verifier; }
+    void setVerifier(TransactionVerifier * verifier);
+    int maxConcurrentFinalizations() const { return _maxConcurrentFinalizations; }
+    void setMaxConcurrentFinalizations(int maxConcurrentFinalizations);
+    // A finalization the store has not answered within this many milliseconds fails and frees its
+    // slot; 0 waits indefinitely
+    int finalizeTimeout() const { return _finalizeTimeout; }
+    void setFinalizeTimeout(int finalizeTimeout);
+    // Consumables finalized within this many milliseconds are consumed together, by quantity; 0 disables
+    int consumptionWindow() const { return _consumptions.window(); }
+    void setConsumptionWindow(int consumptionWindow);
+    // Purchases, restores and finalizations requested before the store is ready wait this many
+    // milliseconds for it, then fail; 0 refuses them straight away
+    int pendingIntentTimeout() const { return _pendingIntentTimeout; }
+    void setPendingIntentTimeout(int pendingIntentTimeout);
+    AbstractProduct::FinalizePolicy finalizePolicy() const { return _finalizePolicy; }
+    void setFinalizePolicy(AbstractProduct::FinalizePolicy policy);
+    // Emit status, store data, products and store state notifications at most once per event loop iteration
+    bool coalesceNotifications() const { return _notifications.isEnabled(); }
+    void setCoalesceNotifications(bool coalesce);
+    // Requests of one kind beyond this many waiting for their rate limit are shed
+    int maxQueuedRequests() const { return _requestLimiter.maxQueued(); }
+    void setMaxQueuedRequests(int maxQueuedRequests);
+    // Decode platform callbacks (e.g. parse their JSON) on a worker thread rather than the store's thread.
+    // Only decoding moves: routing and state changes stay on the store's thread. Has no effect on
+    // backends without a decoder; currently only Google Play has one, so this is a no-op on the
+    // App Store and Microsoft Store.
+    bool decodeStoreEventsInBackground() const { return _storeEvents.decodesInBackground(); }
+    void setDecodeStoreEventsInBackground(bool background);
+
+    // Add a product without creating its AbstractProduct; one is created on first request
+    Q_INVOKABLE qsizetype addProduct(
+        const QString &identifier, AbstractProduct::ProductType type, const QString &microsoftStoreId = QString()
+    );
+    void reserveProducts(qsizetype count) { _catalog.reserve(count); }
+    // Add a product object, e.g. one declared in QML; the store does not take ownership
+    void adoptProduct(AbstractProduct * product);
+    void clearProducts();
+
+    // Limit calls of one kind to perSecond on average, in bursts of up to burst; a rate of 0 (the default) removes
+    // the limit. Requests over the limit wait their turn, or fail once maxQueuedRequests are waiting.
+    Q_INVOKABLE void setRequestRateLimit(AbstractStoreBackend::RequestKind kind, double perSecond, int burst);
+    // {admitted, delayed, shed, queued} for one kind of request
+    Q_INVOKABLE QVariantMap requestCounters(AbstractStoreBackend::RequestKind kind) const;
+
+    // Format a numeric price, e.g. a total over several products, the same way for every call
+    Q_INVOKABLE QString formatPrice(qint64 priceMicros, const QString &currencyCode);
+
+    // Newest first, read from the local history without contacting the store. Invalid dates leave the range open.
+    Q_INVOKABLE QList<TransactionRecord> transactionHistory(
+        const QString &productId = QString(),
+        const QDateTime &from = QDateTime(),
+        const QDateTime &to = QDateTime(),
+        int offset = 0,
+        int limit = 50
+    );
 
     virtual void startConnection() = 0;
-    virtual void registerProduct(AbstractProduct * product) = 0;
+    virtual void registerProduct(const QString &identifier) = 0;
     virtual void purchaseProduct(AbstractProduct * product) = 0;
     virtual void consumePurchase(Transaction transaction) = 0;
 
     Q_INVOKABLE void restorePurchases();
     Q_INVOKABLE virtual void finalize(Transaction transaction);
+    // Finalize several transactions at once; finalizeAllCompleted() reports every outcome together
+    Q_INVOKABLE void finalizeAll(const QList<Transaction> &transactions);
+    // Completes a transaction delivered under AcknowledgedFinalize; finalized in the next batch
+    Q_INVOKABLE void acknowledge(Transaction transaction);
+    // Write the snapshot now; also done on destruction and shortly after product data changes
+    Q_INVOKABLE void saveSnapshot();
 
     // Transaction processing control (cross-platform defensive programming)
-    Q_INVOKABLE virtual void enableProcessing();
+    Q_INVOKABLE void enableProcessing();
 
 protected:
     explicit AbstractStoreBackend(QObject * parent = nullptr);
@@ -68,21 +220,194 @@ protected:
     void setConnected(bool connected);
     void setCanMakePurchases(bool canMakePurchases);
     void setIsRestoringPurchases(bool restoring);
+    // Only the first call for each milestone counts
+    void recordMilestone(StartupMilestones::Milestone milestone);
+
+    // Catalog updates from platform callbacks; forwarded to the facade when one exists
+    void setProductStatus(ProductCatalog::Handle handle, AbstractProduct::ProductStatus status);
+    void applyStoreData(
+        ProductCatalog::Handle handle, const ProductStoreData &data, AbstractProduct::ProductStatus status
+    );
+    // The registration in flight only refreshes a product that is already registered; check before
+    // applying its result, and do not announce it again with productRegistered()
+    bool isRefreshing(ProductCatalog::Handle handle) const { return _refreshing.contains(handle); }
+
+    // Thread-safe: platform callbacks record events here rather than touching the store from their own thread.
+    // Events are handed to handleStoreEvent() on the store's thread, in batches.
+    void postStoreEvent(StoreEvent event) { _storeEvents.post(std::move(event)); }
+    virtual void handleStoreEvent(const StoreEvent &event);
+    // Prepares each event before handleStoreEvent(); runs on a worker thread with decodeStoreEventsInBackground.
+    // Set in the backend's constructor.
+    void setStoreEventDecoder(StoreEventQueue::Decoder decoder) { _storeEvents.setDecoder(std::move(decoder)); }
 
     // Platform-specific implementation called by restorePurchases()
     virtual void restorePurchasesImpl() = 0;
+    // Emit the transactions held back while processing was disabled; called by enableProcessing().
+    // A restore that completed meanwhile is completed once everything emitted or posted here is handled.
+    virtual void processQueuedTransactions() {}
+
+    // Finalize a batch; each transaction must still report consumePurchaseSucceeded/Failed.
+    // The default calls consumePurchase() with at most maxConcurrentFinalizations in flight.
+    virtual void finalizeBatch(const QList<Transaction> &transactions);
+    // For overrides of finalizeBatch() that finalize several transactions with one store call: runs call
+    // under the consume rate limit, and fails each transaction left unanswered after finalizeTimeout.
+    void submitFinalization(const QList<Transaction> &transactions, RateLimiter::Call call);
 
-    QList<AbstractProduct *> _products;
+    // Consume several purchases of one consumable with a single store call, then report the outcome
+    // with finishConsumeQuantity(). Returns false if the store cannot consume by quantity; each
+    // transaction is then passed to consumePurchase() instead.
+    virtual bool consumeQuantity(const QList<Transaction> &transactions);
+    void finishConsumeQuantity(const QList<Transaction> &transactions, bool succeeded);
+
+    // Platform-specific product facade, created lazily for a catalog row
+    virtual AbstractProduct * createProduct(ProductCatalog::Handle handle) = 0;
+
+    ProductCatalog _catalog;
+    PriceFormatter _priceFormatter;
+    TransactionHistory _history;
+    QPointer<TransactionVerifier> _verifier;
+    QList<Transaction> _verifying; // handed to _verifier, awaiting its verdict
+    int _maxConcurrentFinalizations = 4;
+    AbstractProduct::FinalizePolicy _finalizePolicy = AbstractProduct::ManualFinalize;
     bool _connected = false;
     bool _canMakePurchases = false;
     bool _processingEnabled = false;
     bool _isRestoringPurchases = false;
+    bool _restoreOnConnect = false;
+    bool _incrementalRestore = false;
+    int _restoreResultTtl = 0;
 
 private:
-    static void appendProduct(QQmlListProperty<AbstractProduct> * list, AbstractProduct * product);
-    static qsizetype productCount(QQmlListProperty<AbstractProduct> * list);
-    static AbstractProduct * productAt(QQmlListProperty<AbstractProduct> * list, qsizetype index);
-    static void clearProducts(QQmlListProperty<AbstractProduct> * list);
+    friend class AbstractProduct;
+
+    struct PendingIntent
+    {
+        enum Kind { Purchase, Restore, Finalize };
+
+        Kind kind = Purchase;
+        QString productId;
+        Transaction transaction;
+        QDeadlineTimer deadline;
+    };
+
+    struct FinalizeBatch
+    {
+        QList<FinalizeResult> results;
+        QHash<QString, qsizetype> pending; // transaction key -> index in results
+    };
+
+    void submitRequest(RequestKind kind, RateLimiter::Call call, RateLimiter::Call shed);
+    void requestPurchase(AbstractProduct * product);
+    void registerCatalog();
+    void registerCatalogProduct(ProductCatalog::Handle handle);
+    void scheduleRegistrationCheck();
+    void checkRegistrationComplete();
+    void completeStartupRestore();
+    void logStartupSummary();
+    void completeRestore(int count);
+    void finishQueuedTransactions();
+    void dispatchStoreEvent(const StoreEvent &event);
+    bool noteRestoredOwnership(ProductCatalog::Handle handle, const Transaction &transaction);
+    void finishIncrementalRestore(bool succeeded);
+    void bindProduct(ProductCatalog::Handle handle, AbstractProduct * product);
+    void updateCatalogEntry(const AbstractProduct * product);
+    void releaseProduct(const AbstractProduct * product);
+    void detachProducts();
+    void deliverPurchase(const Transaction &transaction);
+    void onTransactionVerified(const Transaction &transaction, TransactionVerifier::Verdict verdict);
+    void failVerifications();
+    void finishFinalization(const Transaction &transaction, bool succeeded);
+    void trackFinalization(const Transaction &transaction);
+    void requestConsume(const Transaction &transaction);
+    void consumeAggregated(const QList<Transaction> &transactions);
+    void dispatchFinalizations();
+    void applyFinalizePolicy(ProductCatalog::Handle handle, const Transaction &transaction);
+    void scheduleFinalize(const Transaction &transaction);
+    void flushScheduledFinalizations();
+    bool deferIntent(PendingIntent intent);
+    bool isIntentReady(const PendingIntent &intent) const;
+    void runPendingIntents();
+    void expirePendingIntents();
+    void refreshStaleProducts();
+    void scheduleRefresh();
+    // Shows data on the row and its facade, without the bookkeeping of a store report
+    void writeStoreData(
+        ProductCatalog::Handle handle, const ProductStoreData &data, AbstractProduct::ProductStatus status
+    );
+    void applySnapshot(ProductCatalog::Handle handle);
+    void scheduleSnapshot();
+    void recordTransaction(
+        TransactionRecord::Outcome outcome,
+        const QString &productId,
+        const QString &orderId,
+        int error = 0,
+        const QString &message = QString()
+    );
+
+    QList<FinalizeBatch> _finalizeBatches;
+    QList<Transaction> _finalizeQueue;
+    // In flight, from the default finalizeBatch() or submitFinalization(), with the serial number of their dispatch
+    QHash<QString, quint64> _finalizingOrders;
+    quint64 _finalizeSerial = 0;
+    int _finalizeTimeout = 60000;
+    bool _dispatchingFinalizations = false;
+
+    // Finalized by policy: queued for the next finalizeAll(), in flight or awaiting acknowledgement
+    QList<Transaction> _scheduledFinalizations;
+    QSet<QString> _policyOwnedOrders;
+
+    // connect, then register and restore side by side; ready once all are done
+    StartupOrchestrator _startup{[this]() {
+        qCDebug(lcStore) << "Store ready";
+        logStartupSummary();
+        emit readyChanged();
+    }};
+    bool _registrationCheckScheduled = false;
+    StartupMilestones _milestones;
+    bool _startupSummaryLogged = false;
+
+    // Incremental restore: owned unlockables, and those reported by the restore in progress
+    QSet<QString> _ownedProducts;
+    QSet<QString> _restoredOwned;
+
+    // Last successful restore, reused within restoreResultTtl
+    QElapsedTimer _lastRestore;
+    int _lastRestoreCount = 0;
+    QElapsedTimer _startupClock;
+
+    // Requested before the store was ready; run in order once it is
+    QList<PendingIntent> _pendingIntents;
+    QTimer _intentTimer;
+    int _pendingIntentTimeout = 30000;
+    bool _runningIntents = false;
+
+    static constexpr int RequestKindCount = RestoreRequest + 1;
+    RateLimiter _requestLimiter{RequestKindCount};
+
+    NotificationCoalescer _notifications{this};
+    ConsumptionAggregator _consumptions{[this](const QList<Transaction> &group) { consumeAggregated(group); }};
+
+    ProductSearchIndex _searchIndex;
+    QString _searchQuery;
+
+    // Registered rows queried again once their data is older than maxMetadataAge
+    QSet<ProductCatalog::Handle> _refreshing;
+    QTimer _refreshTimer;
+    int _maxMetadataAge = 0;
+    static constexpr int RefreshBatchSize = 25;
+    static constexpr int RefreshBatchInterval = 1000;
+
+    // Rows showing snapshot data that the store has not confirmed yet
+    StoreSnapshot _snapshot;
+    QString _snapshotPath;
+    QSet<ProductCatalog::Handle> _warmRows;
+    QSet<ProductCatalog::Handle> _warmRegistering; // of _warmRows, those with a registration in flight
+    QTimer _snapshotTimer;
+    StoreEventQueue _storeEvents{this, [this](const StoreEvent &event) { dispatchStoreEvent(event); }};
+    // Posted by enableProcessing() behind the backend's queued transactions; backend event types are >= 0
+    static constexpr int QueuedTransactionsDrainedEvent = -1;
+    // Count of a restore that completed while its transactions were held back; -1 when none
+    int _heldRestoreCount = -1;
 
 signals:
     void productsChanged();
@@ -90,15 +415,40 @@ signals:
     void canMakePurchasesChanged();
     void processingEnabledChanged();
     void isRestoringPurchasesChanged();
+    void readyChanged();
+    void startupMilestonesChanged();
+    void restoreOnConnectChanged();
+    void restoreResultTtlChanged();
+    void incrementalRestoreChanged();
+    void ownedProductsChanged();
+    void historyPathChanged();
+    void snapshotPathChanged();
+    void maxMetadataAgeChanged();
+    void searchQueryChanged();
+    void searchResultsChanged();
+    void verifierChanged();
+    void maxConcurrentFinalizationsChanged();
+    void finalizeTimeoutChanged();
+    void finalizePolicyChanged();
+    void consumptionWindowChanged();
+    void pendingIntentTimeoutChanged();
+    void coalesceNotificationsChanged();
+    void decodeStoreEventsInBackgroundChanged();
+    void maxQueuedRequestsChanged();
 
     void productRegistered(AbstractProduct * product);
     void purchaseSucceeded(Transaction transaction);
     void purchasePending(Transaction transaction);
     void purchaseRestored(Transaction transaction);
     void purchaseFailed(const QString &productId, int error, int platformCode, const QString &message);
+    void purchaseVerificationFailed(Transaction transaction, int verdict);
     void consumePurchaseSucceeded(Transaction transaction);
     void consumePurchaseFailed(Transaction transaction);
+    void finalizeAllCompleted(QList<FinalizeResult> results);
     void restorePurchasesSucceeded(int count);
+    // Incremental restore: changes in ownership since the last known state
+    void restoredPurchaseAdded(Transaction transaction);
+    void restoredPurchaseRevoked(const QString &productId);
     void restorePurchasesFailed(int error, int platformCode, const QString &message);
 };
 
@@ -0,0 +1,36 @@
+#ifndef CONSUMPTIONAGGREGATOR_H
+#define CONSUMPTIONAGGREGATOR_H
+
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include <functional>
+
+#include <qt6purchasing/transaction.h>
+
+// Collects consumptions requested within a short window and hands them over grouped by product,
+// so a store that can consume by quantity makes one call per product rather than one per unit.
+class ConsumptionAggregator
+{
+public:
+    using Handler = std::function<void(const QList<Transaction> &)>;
+
+    explicit ConsumptionAggregator(Handler handler);
+
+    // In milliseconds; 0 disables aggregation
+    int window() const { return _timer.interval(); }
+    void setWindow(int window);
+
+    void add(const Transaction &transaction);
+    // Hands over everything collected so far
+    void flush();
+
+private:
+    Handler _handler;
+    QTimer _timer;
+    QList<QString> _productOrder; // products in the order their first consumption arrived
+    QHash<QString, QList<Transaction>> _pending;
+};
+
+#endif // CONSUMPTIONAGGREGATOR_H
@@ -0,0 +1,74 @@
+#ifndef HTTPTRANSACTIONVERIFIER_H
+#define HTTPTRANSACTIONVERIFIER_H
+
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QUrl>
+#include <QVariantMap>
+
+#include <qt6purchasing/transactionverifier.h>
+
+class QNetworkReply;
+
+// Verifies transactions with an HTTP endpoint. Transactions arriving close together are
+// sent as one JSON POST over a reused connection, with at most maxInFlight requests
+// outstanding at a time. Each transaction is identified by an "id" that the server echoes back:
+// the order id, or the purchase token or product id for test purchases without one.
+//
+// Request:  {"transactions": [{"id": "...", "orderId": "...", "productId": "...", "purchaseToken": "..."}]}
+// Response: {"results": [{"id": "...", "valid": true}]}
+class HttpTransactionVerifier : public TransactionVerifier
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QUrl endpoint READ endpoint WRITE setEndpoint NOTIFY endpointChanged FINAL)
+    Q_PROPERTY(QVariantMap headers READ headers WRITE setHeaders NOTIFY headersChanged FINAL)
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize NOTIFY batchSizeChanged FINAL)
+    Q_PROPERTY(int batchDelay READ batchDelay WRITE setBatchDelay NOTIFY batchDelayChanged FINAL)
+    Q_PROPERTY(int maxInFlight READ maxInFlight WRITE setMaxInFlight NOTIFY maxInFlightChanged FINAL)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged FINAL)
+
+public:
+    explicit HttpTransactionVerifier(QObject * parent = nullptr);
+
+    QUrl endpoint() const { return _endpoint; }
+    QVariantMap headers() const { return _headers; }
+    int batchSize() const { return _batchSize; }
+    int batchDelay() const { return _batchTimer.interval(); }
+    int maxInFlight() const { return _maxInFlight; }
+    int timeout() const { return _timeout; }
+
+    void setEndpoint(const QUrl &endpoint);
+    void setHeaders(const QVariantMap &headers);
+    void setBatchSize(int batchSize);
+    void setBatchDelay(int batchDelay);
+    void setMaxInFlight(int maxInFlight);
+    void setTimeout(int timeout);
+
+    void verify(const Transaction &transaction) override;
+
+private:
+    void sendBatches();
+    void handleReply(QNetworkReply * reply, const QList<Transaction> &batch);
+
+    QNetworkAccessManager _network;
+    QTimer _batchTimer;
+    QUrl _endpoint;
+    QVariantMap _headers;
+    QList<Transaction> _queue;
+    int _batchSize = 20;
+    int _maxInFlight = 2;
+    int _inFlight = 0;
+    int _timeout = 15000;
+
+signals:
+    void endpointChanged();
+    void headersChanged();
+    void batchSizeChanged();
+    void batchDelayChanged();
+    void maxInFlightChanged();
+    void timeoutChanged();
+};
+
+#endif // HTTPTRANSACTIONVERIFIER_H
@@ -0,0 +1,50 @@
+#ifndef NOTIFICATIONCOALESCER_H
+#define NOTIFICATIONCOALESCER_H
+
+#include <QList>
+#include <QMetaMethod>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+
+// Defers parameterless change notifications to the end of the current event loop iteration.
+// Each (object, signal) pair marked dirty in the meantime is emitted once, in the order it was
+// first marked, so a burst of updates costs bindings a single re-evaluation. When disabled,
+// notifications are emitted immediately.
+class NotificationCoalescer
+{
+public:
+    explicit NotificationCoalescer(QObject * context) : _context(context) {}
+
+    bool isEnabled() const { return _enabled; }
+    void setEnabled(bool enabled);
+
+    template<typename Object>
+    void notify(Object * object, void (Object::*signal)())
+    {
+        if (_enabled)
+            markDirty(object, QMetaMethod::fromSignal(signal));
+        else
+            emit(object->*signal)();
+    }
+
+    // Emits everything pending now
+    void flush();
+
+private:
+    struct Pending
+    {
+        QPointer<QObject> object;
+        QMetaMethod signal;
+    };
+
+    void markDirty(QObject * object, const QMetaMethod &signal);
+
+    QObject * _context;
+    QList<Pending> _pending;
+    QSet<QPair<const QObject *, int>> _dirty;
+    bool _enabled = false;
+    bool _flushScheduled = false;
+};
+
+#endif // NOTIFICATIONCOALESCER_H
@@ -0,0 +1,34 @@
+#ifndef PRICEFORMATTER_H
+#define PRICEFORMATTER_H
+
+#include <QHash>
+#include <QLocale>
+#include <QString>
+
+// Formats numeric prices (in micro-units of the currency) for display, with as many decimals
+// as the currency uses. Locales and the currency symbols resolved for them are cached, so
+// repeated formatting of a large catalog does no locale lookups after the first product.
+class PriceFormatter
+{
+public:
+    QString format(qint64 priceMicros, const QString &currencyCode, const QLocale &locale = QLocale());
+
+private:
+    struct Currency
+    {
+        QString symbol;
+        int decimals = 2;
+    };
+
+    struct CachedLocale
+    {
+        QLocale locale;
+        QHash<QString, Currency> currencies;
+    };
+
+    CachedLocale &cachedLocale(const QLocale &locale);
+
+    QHash<QString, CachedLocale> _locales;
+};
+
+#endif // PRICEFORMATTER_H
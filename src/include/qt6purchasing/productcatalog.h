@@ -0,0 +1,71 @@
+#ifndef PRODUCTCATALOG_H
+#define PRODUCTCATALOG_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <qt6purchasing/abstractproduct.h>
+
+// Contiguous, column-per-field storage of every product known to a store backend.
+// Rows are addressed by handle (their index) and never move, so a handle stays valid
+// until the catalog is cleared. An AbstractProduct facade is attached to a row only
+// when one is declared in QML or requested from C++.
+class ProductCatalog
+{
+public:
+    using Handle = qsizetype;
+
+    Handle insert(const QString &identifier, AbstractProduct::ProductType type);
+    Handle handle(const QString &identifier) const { return _handles.value(identifier, -1); }
+    bool contains(Handle handle) const { return handle >= 0 && handle < _identifiers.size(); }
+    qsizetype size() const { return _identifiers.size(); }
+    void reserve(qsizetype size);
+    void clear();
+
+    QString identifier(Handle handle) const { return _identifiers.at(handle); }
+    AbstractProduct::ProductType productType(Handle handle) const;
+    AbstractProduct::ProductStatus status(Handle handle) const;
+    QString microsoftStoreId(Handle handle) const { return _microsoftStoreIds.at(handle); }
+    QString title(Handle handle) const { return _titles.at(handle); }
+    QString description(Handle handle) const { return _descriptions.at(handle); }
+    QString price(Handle handle) const { return _prices.at(handle); }
+    qint64 priceMicros(Handle handle) const { return _priceMicros.at(handle); }
+    QString currencyCode(Handle handle) const { return _currencyCodes.at(handle); }
+    ProductStoreData storeData(Handle handle) const;
+    QByteArray platformPayload(Handle handle) const { return _payloads.at(handle); }
+    // When the store last supplied this row's data, on the store's monotonic clock; -1 if never
+    qint64 refreshedAt(Handle handle) const { return _refreshedAt.at(handle); }
+    AbstractProduct * facade(Handle handle) const { return _facades.at(handle); }
+
+    Handle findByMicrosoftStoreId(const QString &microsoftStoreId) const;
+
+    void setIdentifier(Handle handle, const QString &identifier);
+    void setProductType(Handle handle, AbstractProduct::ProductType type);
+    void setStatus(Handle handle, AbstractProduct::ProductStatus status);
+    void setMicrosoftStoreId(Handle handle, const QString &microsoftStoreId);
+    void setStoreData(Handle handle, const ProductStoreData &data);
+    void setPlatformPayload(Handle handle, const QByteArray &payload);
+    void setRefreshedAt(Handle handle, qint64 refreshedAt);
+    void setFacade(Handle handle, AbstractProduct * facade);
+
+private:
+    QList<QString> _identifiers;
+    QList<QString> _microsoftStoreIds;
+    QList<QString> _titles;
+    QList<QString> _descriptions;
+    QList<QString> _prices;
+    QList<qint64> _priceMicros;
+    QList<QString> _currencyCodes;
+    QList<quint8> _types;
+    QList<quint8> _statuses;
+    QList<QByteArray> _payloads; // the store's product description, exactly as received
+    QList<qint64> _refreshedAt;
+    QList<AbstractProduct *> _facades;
+
+    // First row registered under an identifier wins, matching the previous linear lookup
+    QHash<QString, Handle> _handles;
+};
+
+#endif // PRODUCTCATALOG_H
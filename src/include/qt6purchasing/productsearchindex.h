@@ -0,0 +1,39 @@
+#ifndef PRODUCTSEARCHINDEX_H
+#define PRODUCTSEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <qt6purchasing/productcatalog.h>
+
+// Word index over product titles and descriptions, kept up to date row by row as the store
+// reports product data. Words are case-folded with accents removed, so "cafe" finds "Café".
+// Every word of a query must match the start of a word in the product; results are ranked
+// by where and how fully the words matched, then by catalog order.
+class ProductSearchIndex
+{
+public:
+    void update(ProductCatalog::Handle handle, const QString &title, const QString &description);
+    void remove(ProductCatalog::Handle handle);
+    void clear();
+    bool isEmpty() const { return _rowTokens.isEmpty(); }
+
+    QList<ProductCatalog::Handle> search(const QString &query) const;
+
+    static QStringList tokenize(const QString &text);
+
+private:
+    enum Field : quint8 {
+        Title = 0x1,
+        Description = 0x2
+    };
+
+    // token -> rows containing it, with the fields it appears in
+    QMap<QString, QHash<ProductCatalog::Handle, quint8>> _postings;
+    QHash<ProductCatalog::Handle, QStringList> _rowTokens;
+};
+
+#endif // PRODUCTSEARCHINDEX_H
@@ -0,0 +1,60 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QTimer>
+
+#include <deque>
+#include <functional>
+
+// Token buckets in front of outbound calls, one per kind of call. A call runs straight away
+// while its bucket has a token; otherwise it waits its turn, and is shed once maxQueued calls
+// of its kind are already waiting.
+class RateLimiter
+{
+public:
+    using Call = std::function<void()>;
+
+    struct Counters
+    {
+        quint64 admitted = 0; // ran as soon as submitted
+        quint64 delayed = 0;  // waited for a token
+        quint64 shed = 0;
+        qsizetype queued = 0;
+    };
+
+    explicit RateLimiter(int kinds);
+
+    // A rate of 0 leaves the kind unlimited
+    void setLimit(int kind, double perSecond, int burst);
+    double rate(int kind) const { return _buckets.at(kind).rate; }
+    int burst(int kind) const { return _buckets.at(kind).burst; }
+    int maxQueued() const { return _maxQueued; }
+    void setMaxQueued(int maxQueued) { _maxQueued = qMax(0, maxQueued); }
+
+    // Runs call now, later, or not at all; shed runs instead when the call is dropped
+    void submit(int kind, Call call, Call shed);
+    Counters counters(int kind) const;
+
+private:
+    struct Bucket
+    {
+        double rate = 0; // tokens per second
+        int burst = 1;
+        double tokens = 1;
+        QElapsedTimer refilled;
+        std::deque<Call> waiting;
+        Counters counters;
+    };
+
+    void refill(Bucket &bucket);
+    void runWaiting();
+
+    QList<Bucket> _buckets;
+    QTimer _timer;
+    int _maxQueued = 100;
+    bool _running = false;
+};
+
+#endif // RATELIMITER_H
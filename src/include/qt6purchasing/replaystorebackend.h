@@ -0,0 +1,60 @@
+#ifndef REPLAYSTOREBACKEND_H
+#define REPLAYSTOREBACKEND_H
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <qt6purchasing/abstractstorebackend.h>
+#include <qt6purchasing/storerecorder.h>
+
+class ReplayStoreProduct : public AbstractProduct
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayStoreProduct(QObject * parent = nullptr) : AbstractProduct(parent) {}
+};
+
+// Plays back a StoreRecorder log as if a store were reporting it, on any platform. Products
+// registered in the log are added to the catalog if the app has not declared them. Purchases,
+// consumptions and restores requested by the app are not sent anywhere: their outcomes are
+// whatever the log contains.
+class ReplayStoreBackend : public AbstractStoreBackend
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayStoreBackend(QObject * parent = nullptr);
+
+    bool load(const QString &fileName);
+    // 1 replays at the recorded pace, 10 ten times faster; 0 or less as fast as possible
+    void setSpeed(double speed) { _speed = speed; }
+    double speed() const { return _speed; }
+    bool isFinished() const { return _next >= _records.size(); }
+
+    void startConnection() override;
+    void registerProduct(const QString &identifier) override;
+    void purchaseProduct(AbstractProduct * product) override;
+    void consumePurchase(Transaction transaction) override;
+    bool canMakePurchases() const override { return _canMakePurchases; }
+
+protected:
+    void restorePurchasesImpl() override;
+    AbstractProduct * createProduct(ProductCatalog::Handle handle) override;
+
+private:
+    void scheduleNext();
+    void replayNext();
+    void replay(const StoreRecord &record);
+
+    QList<StoreRecord> _records;
+    qsizetype _next = 0;
+    double _speed = 1.0;
+    QElapsedTimer _clock;
+    QTimer _timer;
+
+signals:
+    void replayFinished();
+};
+
+#endif // REPLAYSTOREBACKEND_H
@@ -0,0 +1,57 @@
+#ifndef STARTUPMILESTONES_H
+#define STARTUPMILESTONES_H
+
+#include <QObject>
+
+#include <array>
+
+// When the store reached each point of its startup, in milliseconds since the backend was
+// constructed; -1 until reached. Times come from the monotonic clock.
+struct StartupMilestones
+{
+    Q_GADGET
+
+    Q_PROPERTY(qint64 constructedAt MEMBER constructedAt CONSTANT)
+    Q_PROPERTY(qint64 connected READ connected CONSTANT)
+    Q_PROPERTY(qint64 firstProductRegistered READ firstProductRegistered CONSTANT)
+    Q_PROPERTY(qint64 allProductsRegistered READ allProductsRegistered CONSTANT)
+    Q_PROPERTY(qint64 processingEnabled READ processingEnabled CONSTANT)
+    Q_PROPERTY(qint64 initialRestoreComplete READ initialRestoreComplete CONSTANT)
+    Q_PROPERTY(qint64 queuedTransactionsDrained READ queuedTransactionsDrained CONSTANT)
+    Q_PROPERTY(bool complete READ isComplete CONSTANT)
+
+public:
+    enum Milestone {
+        Connected,
+        FirstProductRegistered,
+        AllProductsRegistered,
+        ProcessingEnabled,
+        InitialRestoreComplete,
+        QueuedTransactionsDrained,
+        MilestoneCount
+    };
+    Q_ENUM(Milestone)
+
+    qint64 at(Milestone milestone) const { return elapsed[milestone]; }
+    bool isReached(Milestone milestone) const { return elapsed[milestone] >= 0; }
+    bool isComplete() const
+    {
+        for (qint64 time : elapsed) {
+            if (time < 0)
+                return false;
+        }
+        return true;
+    }
+
+    qint64 connected() const { return at(Connected); }
+    qint64 firstProductRegistered() const { return at(FirstProductRegistered); }
+    qint64 allProductsRegistered() const { return at(AllProductsRegistered); }
+    qint64 processingEnabled() const { return at(ProcessingEnabled); }
+    qint64 initialRestoreComplete() const { return at(InitialRestoreComplete); }
+    qint64 queuedTransactionsDrained() const { return at(QueuedTransactionsDrained); }
+
+    qint64 constructedAt = -1; // QElapsedTimer::msecsSinceReference() when the backend was constructed
+    std::array<qint64, MilestoneCount> elapsed{-1, -1, -1, -1, -1, -1};
+};
+
+#endif // STARTUPMILESTONES_H
@@ -0,0 +1,52 @@
+#ifndef STARTUPORCHESTRATOR_H
+#define STARTUPORCHESTRATOR_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <utility>
+
+// A small dependency graph of startup steps. A step starts as soon as every step it depends on
+// has completed, so independent steps overlap; each step reports completion through complete().
+class StartupOrchestrator
+{
+public:
+    using Action = std::function<void()>;
+    using FinishedHandler = std::function<void()>;
+
+    explicit StartupOrchestrator(FinishedHandler onFinished) : _onFinished(std::move(onFinished)) {}
+
+    // Steps must be added before start(), after the steps they depend on
+    void addStep(const QString &name, const QStringList &dependencies, Action action);
+    void start();
+    // Back to the first steps, e.g. once what the completed steps established has been lost
+    void restart();
+    void complete(const QString &name);
+
+    bool isRunning(const QString &name) const;
+    bool isComplete(const QString &name) const;
+    bool isFinished() const { return _finished; }
+
+private:
+    enum State { Waiting, Running, Complete };
+
+    struct Step
+    {
+        QString name;
+        QStringList dependencies;
+        Action action;
+        State state = Waiting;
+    };
+
+    qsizetype indexOf(const QString &name) const;
+    void startReadySteps();
+
+    QList<Step> _steps;
+    FinishedHandler _onFinished;
+    bool _starting = false;
+    bool _finished = false;
+};
+
+#endif // STARTUPORCHESTRATOR_H
@@ -0,0 +1,151 @@
+#ifndef STOREEVENTQUEUE_H
+#define STOREEVENTQUEUE_H
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <utility>
+
+#include <qt6purchasing/abstractproduct.h>
+#include <qt6purchasing/transaction.h>
+
+class QThread;
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov's intrusive design).
+// push() may be called from any thread; pop() only from the consumer thread.
+template<typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : _head(&_stub), _tail(&_stub) {}
+    ~MpscQueue()
+    {
+        T discarded;
+        while (pop(discarded)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(T value) { pushNode(new Node(std::move(value))); }
+
+    // Returns false when empty, or when a producer is midway through a push; it will be visible shortly
+    bool pop(T &value)
+    {
+        Node * tail = _tail;
+        Node * next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &_stub) {
+            if (!next)
+                return false;
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (!next) {
+            if (tail != _head.load(std::memory_order_acquire))
+                return false;
+
+            // tail is the last node; put the stub behind it so it can be unlinked
+            pushNode(&_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+        }
+
+        _tail = next;
+        value = std::move(tail->value);
+        delete tail;
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+        explicit Node(T &&v) : value(std::move(v)) {}
+
+        std::atomic<Node *> next{nullptr};
+        T value;
+    };
+
+    void pushNode(Node * node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node * previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    Node _stub;
+    std::atomic<Node *> _head;
+    Node * _tail;
+};
+
+// A platform callback, recorded on whatever thread it arrived and handled on the store's thread
+struct StoreEvent
+{
+    int type = 0; // defined by the backend posting the event
+    int code = 0; // e.g. an error, a count or a flag
+    int platformCode = 0;
+    QString text; // e.g. a product identifier or a JSON payload
+    QString message;
+    Transaction transaction;
+
+    // Filled by the queue's decoder, e.g. from a JSON payload in text
+    ProductStoreData storeData;
+    QByteArray payload;
+    bool decoded = false;
+};
+
+// Collects StoreEvents from any thread and hands them to a handler on the receiver's thread.
+// A burst of events costs one queued wakeup, after which they are handled in one batch.
+// Events pass through an optional decoder first, which can run on a worker thread so that
+// parsing stays off the receiver's thread.
+class StoreEventQueue
+{
+public:
+    using Handler = std::function<void(const StoreEvent &)>;
+    // Must be thread-safe when decoding in the background
+    using Decoder = std::function<void(StoreEvent &)>;
+
+    StoreEventQueue(QObject * receiver, Handler handler) : _receiver(receiver), _handler(std::move(handler)) {}
+    ~StoreEventQueue();
+
+    StoreEventQueue(const StoreEventQueue &) = delete;
+    StoreEventQueue &operator=(const StoreEventQueue &) = delete;
+
+    void post(StoreEvent event);
+
+    // Set before the first event is posted
+    void setDecoder(Decoder decoder) { _decoder = std::move(decoder); }
+    // Receiver's thread only
+    bool decodesInBackground() const { return _decodeThread != nullptr; }
+    void setDecodeInBackground(bool background);
+
+private:
+    void drain();
+    void scheduleDrain();
+    void decode();
+    bool scheduleDecode(); // false once the worker is stopped
+    void stopDecodeThread();
+
+    MpscQueue<StoreEvent> _posted; // awaiting decoding, by the worker when there is one
+    MpscQueue<StoreEvent> _events; // decoded by the worker; always older than anything in _posted
+    std::atomic<bool> _wakeupPending{false};
+    std::atomic<bool> _decodeWakeupPending{false};
+    std::atomic<bool> _background{false};
+    QObject * _receiver;
+    Handler _handler;
+    Decoder _decoder;
+    // Set and cleared on the receiver's thread; _decodeContext is read by producers under the mutex
+    QMutex _decodeMutex;
+    QThread * _decodeThread = nullptr;
+    QObject * _decodeContext = nullptr; // lives on _decodeThread
+};
+
+#endif // STOREEVENTQUEUE_H
@@ -0,0 +1,9 @@
+#ifndef STORELOGGING_H
+#define STORELOGGING_H
+
+#include <QLoggingCategory>
+
+// "qt6purchasing.store": the Store, its helpers and the platform backends all log here
+Q_DECLARE_LOGGING_CATEGORY(lcStore)
+
+#endif // STORELOGGING_H
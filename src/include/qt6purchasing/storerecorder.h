@@ -0,0 +1,66 @@
+#ifndef STORERECORDER_H
+#define STORERECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+#include <qt6purchasing/abstractstorebackend.h>
+
+// One callback reported by a store, as written by StoreRecorder and played back by ReplayStoreBackend
+struct StoreRecord
+{
+    enum Type : quint8 {
+        Connected,         // code: connected
+        CanMakePurchases,  // code: can make purchases
+        ProductRegistered, // productId, productType, data
+        PurchaseSucceeded, // transaction
+        PurchasePending,   // transaction
+        PurchaseRestored,  // transaction
+        PurchaseFailed,    // productId, code: error, platformCode, message
+        ConsumeSucceeded,  // transaction
+        ConsumeFailed,     // transaction
+        RestoreSucceeded,  // code: count
+        RestoreFailed      // code: error, platformCode, message
+    };
+
+    qint64 timestampUs = 0; // since recording started
+    Type type = Connected;
+    int code = 0;
+    int platformCode = 0;
+    QString productId;
+    AbstractProduct::ProductType productType = AbstractProduct::None;
+    QString message;
+    Transaction transaction;
+    ProductStoreData data;
+};
+
+// Writes every callback a store reports through its signals to a compact, timestamped log, so
+// field sequences (connection, registrations, restore bursts, pending purchases completing) can
+// be replayed with ReplayStoreBackend.
+class StoreRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StoreRecorder(AbstractStoreBackend * store, QObject * parent = nullptr);
+    ~StoreRecorder() override { stop(); }
+
+    bool start(const QString &fileName);
+    void stop();
+    bool isRecording() const { return _file.isOpen(); }
+
+    static QList<StoreRecord> load(const QString &fileName);
+
+private:
+    void write(StoreRecord record);
+
+    QPointer<AbstractStoreBackend> _store;
+    QFile _file;
+    QElapsedTimer _clock;
+    QList<QMetaObject::Connection> _connections;
+};
+
+#endif // STORERECORDER_H
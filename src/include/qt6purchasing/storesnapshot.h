@@ -0,0 +1,33 @@
+#ifndef STORESNAPSHOT_H
+#define STORESNAPSHOT_H
+
+#include <QHash>
+#include <QString>
+
+#include <qt6purchasing/productcatalog.h>
+
+// Registered products as last reported by the store, kept on disk so the next start can show
+// them before the store connects. The file is a versioned binary image: a header, one fixed-size
+// entry per product and a block of UTF-16 strings, read in one pass from a memory mapping.
+class StoreSnapshot
+{
+public:
+    struct Product
+    {
+        AbstractProduct::ProductType type = AbstractProduct::None;
+        QString microsoftStoreId;
+        ProductStoreData data;
+    };
+
+    bool load(const QString &fileName);
+    static bool save(const QString &fileName, const ProductCatalog &catalog);
+
+    bool isEmpty() const { return _products.isEmpty(); }
+    void clear() { _products.clear(); }
+    const Product * find(const QString &identifier) const;
+
+private:
+    QHash<QString, Product> _products;
+};
+
+#endif // STORESNAPSHOT_H
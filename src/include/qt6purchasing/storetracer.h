@@ -0,0 +1,86 @@
+#ifndef STORETRACER_H
+#define STORETRACER_H
+
+#include <QString>
+
+#include <atomic>
+
+// Optional tracing of the purchase pipeline, exported as Chrome trace-event JSON that loads in
+// Perfetto or chrome://tracing. Off by default: call setEnabled(), or set QT6PURCHASING_TRACE to
+// a file name and the trace is written there when the application exits.
+//
+// Every thread records into its own ring buffer, under a lock that only an export contends. Once a
+// thread has recorded more than BufferCapacity events since the last clear(), each new event
+// overwrites its oldest. Event names must be string literals.
+class StoreTracer
+{
+public:
+    static constexpr int BufferCapacity = 8192;
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    // A span on the current thread
+    static void begin(const char * name, const QString &id = QString())
+    {
+        if (isEnabled())
+            record('B', name, id);
+    }
+    static void end(const char * name)
+    {
+        if (isEnabled())
+            record('E', name, QString());
+    }
+
+    // An operation that may start and finish on different threads, correlated by id
+    static void beginAsync(const char * name, const QString &id)
+    {
+        if (isEnabled())
+            record('b', name, id);
+    }
+    static void endAsync(const char * name, const QString &id)
+    {
+        if (isEnabled())
+            record('e', name, id);
+    }
+
+    static void instant(const char * name, const QString &id = QString())
+    {
+        if (isEnabled())
+            record('i', name, id);
+    }
+
+    static bool writeChromeTrace(const QString &fileName);
+    // Leaves recorded events out of the next export
+    static void clear();
+
+private:
+    static void record(char phase, const char * name, const QString &id);
+
+    static std::atomic<bool> s_enabled;
+};
+
+// Records a span for the enclosing scope
+class StoreTraceSpan
+{
+public:
+    explicit StoreTraceSpan(const char * name, const QString &id = QString())
+        : _name(StoreTracer::isEnabled() ? name : nullptr)
+    {
+        if (_name)
+            StoreTracer::begin(_name, id);
+    }
+    ~StoreTraceSpan()
+    {
+        if (_name)
+            StoreTracer::end(_name);
+    }
+
+    StoreTraceSpan(const StoreTraceSpan &) = delete;
+    StoreTraceSpan &operator=(const StoreTraceSpan &) = delete;
+
+private:
+    const char * _name;
+};
+
+#endif // STORETRACER_H
@@ -1,13 +1,12 @@
 #ifndef TRANSACTION_H
 #define TRANSACTION_H
 
-#include <QQmlEngine>
+#include <QObject>
 #include <QString>
 
 struct Transaction
 {
     Q_GADGET
-    QML_VALUE_TYPE(transaction)
 
     Q_PROPERTY(QString orderId MEMBER orderId CONSTANT)
     Q_PROPERTY(QString productId MEMBER productId CONSTANT)
@@ -18,6 +17,27 @@ public:
 
     // Platform-specific fields (not exposed to QML)
     QString purchaseToken; // Android only - for purchase acknowledgment
+
+    // Identifies the transaction; test purchases on some stores carry no order id
+    QString key() const
+    {
+        if (!orderId.isEmpty())
+            return orderId;
+        return purchaseToken.isEmpty() ? productId : purchaseToken;
+    }
+};
+
+// Outcome of one transaction in a finalizeAll() batch
+struct FinalizeResult
+{
+    Q_GADGET
+
+    Q_PROPERTY(Transaction transaction MEMBER transaction CONSTANT)
+    Q_PROPERTY(bool succeeded MEMBER succeeded CONSTANT)
+
+public:
+    Transaction transaction;
+    bool succeeded = false;
 };
 
 #endif // TRANSACTION_H
@@ -0,0 +1,98 @@
+#ifndef TRANSACTIONHISTORY_H
+#define TRANSACTIONHISTORY_H
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+struct TransactionRecord
+{
+    Q_GADGET
+
+    Q_PROPERTY(QDateTime timestamp READ timestamp CONSTANT)
+    Q_PROPERTY(QString productId MEMBER productId CONSTANT)
+    Q_PROPERTY(QString orderId MEMBER orderId CONSTANT)
+    Q_PROPERTY(Outcome outcome MEMBER outcome CONSTANT)
+    Q_PROPERTY(int error MEMBER error CONSTANT)
+    Q_PROPERTY(QString message MEMBER message CONSTANT)
+
+public:
+    enum Outcome { Purchased, Pending, Restored, Failed, Consumed, ConsumeFailed };
+    Q_ENUM(Outcome)
+
+    QDateTime timestamp() const { return QDateTime::fromMSecsSinceEpoch(timestampMs); }
+
+    qint64 timestampMs = 0; // milliseconds since the epoch
+    QString productId;
+    QString orderId;
+    Outcome outcome = Purchased;
+    int error = 0; // AbstractStoreBackend::PurchaseError for failed purchases
+    QString message;
+};
+
+// Append-only on-disk log of transactions. Records are written to a data file and located
+// through a fixed-size index sorted by time, in which each entry also links to the previous
+// entry for the same product. Queries page through the memory-mapped index and read only
+// the records they return, so the cost does not grow with years of history.
+class TransactionHistory
+{
+public:
+    TransactionHistory() = default;
+    ~TransactionHistory() { close(); }
+
+    bool open(const QString &directory);
+    void close();
+    bool isOpen() const { return _index.isOpen(); }
+    QString directory() const { return _directory; }
+    qsizetype size() const { return _entryCount; }
+
+    bool append(TransactionRecord record);
+
+    // Newest first. Bounds are inclusive, in milliseconds since the epoch; an empty productId
+    // matches every product.
+    QList<TransactionRecord> query(
+        const QString &productId, qint64 from, qint64 to, qsizetype offset = 0, qsizetype limit = 50
+    );
+
+private:
+    struct IndexEntry
+    {
+        qint64 timestamp;
+        qint64 offset;
+        quint32 product;
+        quint32 previous; // previous entry for the same product, or NoEntry
+    };
+
+    static constexpr quint32 NoEntry = 0xffffffff;
+    static constexpr qint64 HeaderSize = 8;
+    static constexpr qint64 EntrySize = 24;
+
+    bool openFile(QFile &file, const QString &name, quint32 magic);
+    bool loadProducts();
+    void recover();
+    quint32 productIndex(const QString &productId);
+    bool mapIndex();
+    void unmapIndex();
+    IndexEntry entry(qsizetype number) const;
+    qsizetype lowerBound(qint64 timestamp) const;
+    bool readRecord(const IndexEntry &entry, TransactionRecord &record);
+
+    QString _directory;
+    QFile _index;
+    QFile _data;
+    QFile _products;
+    uchar * _mappedIndex = nullptr;
+    qsizetype _mappedCount = 0;
+    qsizetype _entryCount = 0;
+    qint64 _lastTimestamp = 0;
+
+    // The product table is small (one row per identifier ever seen) and kept in memory
+    QList<QString> _productIds;
+    QHash<QString, quint32> _productIndexes;
+    QList<quint32> _lastEntries;
+};
+
+#endif // TRANSACTIONHISTORY_H
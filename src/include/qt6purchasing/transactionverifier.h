@@ -0,0 +1,32 @@
+#ifndef TRANSACTIONVERIFIER_H
+#define TRANSACTIONVERIFIER_H
+
+#include <QObject>
+
+#include <qt6purchasing/transaction.h>
+
+// A verification stage between the store and products. When one is set on the store,
+// successful purchases are handed to verify() and only reach their product once a
+// verdict is reported through verified().
+class TransactionVerifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Verdict {
+        Valid,
+        Invalid, // the server rejected the transaction
+        Error    // no verdict could be obtained
+    };
+    Q_ENUM(Verdict)
+
+    virtual void verify(const Transaction &transaction) = 0;
+
+protected:
+    explicit TransactionVerifier(QObject * parent = nullptr) : QObject(parent) {}
+
+signals:
+    void verified(const Transaction &transaction, TransactionVerifier::Verdict verdict);
+};
+
+#endif // TRANSACTIONVERIFIER_H
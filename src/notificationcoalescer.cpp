@@ -0,0 +1,42 @@
+#include <qt6purchasing/notificationcoalescer.h>
+
+#include <utility>
+
+void NotificationCoalescer::setEnabled(bool enabled)
+{
+    if (_enabled == enabled)
+        return;
+
+    _enabled = enabled;
+    if (!_enabled)
+        flush();
+}
+
+void NotificationCoalescer::markDirty(QObject * object, const QMetaMethod &signal)
+{
+    if (_dirty.contains({object, signal.methodIndex()}))
+        return;
+
+    _dirty.insert({object, signal.methodIndex()});
+    _pending.append({object, signal});
+
+    if (!_flushScheduled) {
+        _flushScheduled = true;
+        QMetaObject::invokeMethod(_context, [this]() { flush(); }, Qt::QueuedConnection);
+    }
+}
+
+void NotificationCoalescer::flush()
+{
+    _flushScheduled = false;
+
+    // Handlers may mark objects dirty again; those are emitted in the next iteration
+    const QList<Pending> pending = std::exchange(_pending, {});
+    _dirty.clear();
+
+    for (const Pending &entry : pending) {
+        // Objects destroyed since being marked are skipped
+        if (entry.object)
+            entry.signal.invoke(entry.object.data(), Qt::DirectConnection);
+    }
+}
@@ -0,0 +1,50 @@
+#include <qt6purchasing/priceformatter.h>
+
+namespace {
+// ISO 4217 minor units, for the currencies that do not use two
+int currencyDecimals(const QString &currencyCode)
+{
+    static const QHash<QString, int> exceptions = {
+        {"BIF", 0}, {"CLP", 0}, {"DJF", 0}, {"GNF", 0}, {"ISK", 0}, {"JPY", 0}, {"KMF", 0},
+        {"KRW", 0}, {"PYG", 0}, {"RWF", 0}, {"UGX", 0}, {"UYI", 0}, {"VND", 0}, {"VUV", 0},
+        {"XAF", 0}, {"XOF", 0}, {"XPF", 0}, {"BHD", 3}, {"IQD", 3}, {"JOD", 3}, {"KWD", 3},
+        {"LYD", 3}, {"OMR", 3}, {"TND", 3}
+    };
+    return exceptions.value(currencyCode, 2);
+}
+} // namespace
+
+QString PriceFormatter::format(qint64 priceMicros, const QString &currencyCode, const QLocale &locale)
+{
+    if (priceMicros < 0)
+        return QString();
+
+    CachedLocale &cached = cachedLocale(locale);
+    const double amount = static_cast<double>(priceMicros) / 1000000.0;
+
+    // Without a currency there is no symbol to show, not even the user's own
+    if (currencyCode.isEmpty())
+        return cached.locale.toString(amount, 'f', 2);
+
+    auto currency = cached.currencies.constFind(currencyCode);
+    if (currency == cached.currencies.constEnd()) {
+        // QLocale only knows the symbol of its own currency; other currencies show their ISO code
+        const bool ownCurrency = currencyCode == cached.locale.currencySymbol(QLocale::CurrencyIsoCode);
+        currency = cached.currencies.insert(
+            currencyCode,
+            {ownCurrency ? cached.locale.currencySymbol(QLocale::CurrencySymbol) : currencyCode,
+             currencyDecimals(currencyCode)}
+        );
+    }
+
+    return cached.locale.toCurrencyString(amount, currency->symbol, currency->decimals);
+}
+
+PriceFormatter::CachedLocale &PriceFormatter::cachedLocale(const QLocale &locale)
+{
+    const QString name = locale.name();
+    auto it = _locales.find(name);
+    if (it == _locales.end())
+        it = _locales.insert(name, {locale, {}});
+    return *it;
+}
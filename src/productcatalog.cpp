@@ -0,0 +1,139 @@
+#include <qt6purchasing/productcatalog.h>
+
+ProductCatalog::Handle ProductCatalog::insert(const QString &identifier, AbstractProduct::ProductType type)
+{
+    const Handle handle = _identifiers.size();
+
+    _identifiers.append(identifier);
+    _microsoftStoreIds.append(QString());
+    _titles.append(QString());
+    _descriptions.append(QString());
+    _prices.append(QString());
+    _priceMicros.append(-1);
+    _currencyCodes.append(QString());
+    _types.append(static_cast<quint8>(type));
+    _statuses.append(static_cast<quint8>(AbstractProduct::Uninitialized));
+    _payloads.append(QByteArray());
+    _refreshedAt.append(-1);
+    _facades.append(nullptr);
+
+    if (!identifier.isEmpty() && !_handles.contains(identifier))
+        _handles.insert(identifier, handle);
+
+    return handle;
+}
+
+void ProductCatalog::reserve(qsizetype size)
+{
+    _identifiers.reserve(size);
+    _microsoftStoreIds.reserve(size);
+    _titles.reserve(size);
+    _descriptions.reserve(size);
+    _prices.reserve(size);
+    _priceMicros.reserve(size);
+    _currencyCodes.reserve(size);
+    _types.reserve(size);
+    _statuses.reserve(size);
+    _payloads.reserve(size);
+    _refreshedAt.reserve(size);
+    _facades.reserve(size);
+    _handles.reserve(size);
+}
+
+void ProductCatalog::clear()
+{
+    _identifiers.clear();
+    _microsoftStoreIds.clear();
+    _titles.clear();
+    _descriptions.clear();
+    _prices.clear();
+    _priceMicros.clear();
+    _currencyCodes.clear();
+    _types.clear();
+    _statuses.clear();
+    _payloads.clear();
+    _refreshedAt.clear();
+    _facades.clear();
+    _handles.clear();
+}
+
+AbstractProduct::ProductType ProductCatalog::productType(Handle handle) const
+{
+    return static_cast<AbstractProduct::ProductType>(_types.at(handle));
+}
+
+AbstractProduct::ProductStatus ProductCatalog::status(Handle handle) const
+{
+    return static_cast<AbstractProduct::ProductStatus>(_statuses.at(handle));
+}
+
+ProductStoreData ProductCatalog::storeData(Handle handle) const
+{
+    ProductStoreData data;
+    data.title = _titles.at(handle);
+    data.description = _descriptions.at(handle);
+    data.price = _prices.at(handle);
+    data.priceMicros = _priceMicros.at(handle);
+    data.currencyCode = _currencyCodes.at(handle);
+    return data;
+}
+
+ProductCatalog::Handle ProductCatalog::findByMicrosoftStoreId(const QString &microsoftStoreId) const
+{
+    if (microsoftStoreId.isEmpty())
+        return -1;
+    return _microsoftStoreIds.indexOf(microsoftStoreId);
+}
+
+void ProductCatalog::setIdentifier(Handle handle, const QString &identifier)
+{
+    const QString previous = _identifiers.at(handle);
+    if (previous == identifier)
+        return;
+
+    if (_handles.value(previous, -1) == handle)
+        _handles.remove(previous);
+
+    _identifiers[handle] = identifier;
+    if (!identifier.isEmpty() && !_handles.contains(identifier))
+        _handles.insert(identifier, handle);
+}
+
+void ProductCatalog::setProductType(Handle handle, AbstractProduct::ProductType type)
+{
+    _types[handle] = static_cast<quint8>(type);
+}
+
+void ProductCatalog::setStatus(Handle handle, AbstractProduct::ProductStatus status)
+{
+    _statuses[handle] = static_cast<quint8>(status);
+}
+
+void ProductCatalog::setMicrosoftStoreId(Handle handle, const QString &microsoftStoreId)
+{
+    _microsoftStoreIds[handle] = microsoftStoreId;
+}
+
+void ProductCatalog::setStoreData(Handle handle, const ProductStoreData &data)
+{
+    _titles[handle] = data.title;
+    _descriptions[handle] = data.description;
+    _prices[handle] = data.price;
+    _priceMicros[handle] = data.priceMicros;
+    _currencyCodes[handle] = data.currencyCode;
+}
+
+void ProductCatalog::setPlatformPayload(Handle handle, const QByteArray &payload)
+{
+    _payloads[handle] = payload;
+}
+
+void ProductCatalog::setRefreshedAt(Handle handle, qint64 refreshedAt)
+{
+    _refreshedAt[handle] = refreshedAt;
+}
+
+void ProductCatalog::setFacade(Handle handle, AbstractProduct * facade)
+{
+    _facades[handle] = facade;
+}
@@ -0,0 +1,117 @@
+#include <qt6purchasing/productsearchindex.h>
+
+#include <algorithm>
+
+void ProductSearchIndex::update(ProductCatalog::Handle handle, const QString &title, const QString &description)
+{
+    remove(handle);
+
+    QHash<QString, quint8> fields;
+    for (const QString &token : tokenize(title))
+        fields[token] |= Title;
+    for (const QString &token : tokenize(description))
+        fields[token] |= Description;
+    if (fields.isEmpty())
+        return;
+
+    QStringList &tokens = _rowTokens[handle];
+    tokens.reserve(fields.size());
+    for (auto it = fields.cbegin(); it != fields.cend(); ++it) {
+        _postings[it.key()].insert(handle, it.value());
+        tokens.append(it.key());
+    }
+}
+
+void ProductSearchIndex::remove(ProductCatalog::Handle handle)
+{
+    const auto row = _rowTokens.constFind(handle);
+    if (row == _rowTokens.cend())
+        return;
+
+    for (const QString &token : row.value()) {
+        auto posting = _postings.find(token);
+        if (posting == _postings.end())
+            continue;
+        posting->remove(handle);
+        if (posting->isEmpty())
+            _postings.erase(posting);
+    }
+    _rowTokens.erase(row);
+}
+
+void ProductSearchIndex::clear()
+{
+    _postings.clear();
+    _rowTokens.clear();
+}
+
+QList<ProductCatalog::Handle> ProductSearchIndex::search(const QString &query) const
+{
+    const QStringList terms = tokenize(query);
+    if (terms.isEmpty())
+        return {};
+
+    QHash<ProductCatalog::Handle, int> scores;
+    for (qsizetype i = 0; i < terms.size(); ++i) {
+        const QString &term = terms.at(i);
+
+        // Tokens are sorted, so those starting with the term are adjacent
+        QHash<ProductCatalog::Handle, int> termScores;
+        for (auto it = _postings.lowerBound(term); it != _postings.cend() && it.key().startsWith(term); ++it) {
+            const bool whole = it.key().size() == term.size();
+            for (auto row = it->cbegin(); row != it->cend(); ++row) {
+                const int score = (row.value() & Title) ? (whole ? 8 : 4) : (whole ? 2 : 1);
+                int &best = termScores[row.key()];
+                best = qMax(best, score);
+            }
+        }
+
+        if (i == 0) {
+            scores = termScores;
+        } else {
+            for (auto it = scores.begin(); it != scores.end();) {
+                const auto match = termScores.constFind(it.key());
+                if (match == termScores.cend()) {
+                    it = scores.erase(it);
+                } else {
+                    it.value() += match.value();
+                    ++it;
+                }
+            }
+        }
+        if (scores.isEmpty())
+            return {};
+    }
+
+    QList<ProductCatalog::Handle> results = scores.keys();
+    std::sort(results.begin(), results.end(), [&scores](ProductCatalog::Handle a, ProductCatalog::Handle b) {
+        const int scoreA = scores.value(a);
+        const int scoreB = scores.value(b);
+        return scoreA != scoreB ? scoreA > scoreB : a < b;
+    });
+    return results;
+}
+
+QStringList ProductSearchIndex::tokenize(const QString &text)
+{
+    // Compatibility decomposition splits accented letters into a base letter and marks that are dropped
+    const QList<uint> codePoints = text.normalized(QString::NormalizationForm_KD).toCaseFolded().toUcs4();
+
+    QStringList tokens;
+    QList<char32_t> token;
+    for (const uint codePoint : codePoints) {
+        if (QChar::category(codePoint) == QChar::Mark_NonSpacing)
+            continue;
+
+        if (QChar::isLetterOrNumber(codePoint)) {
+            token.append(static_cast<char32_t>(codePoint));
+        } else if (!token.isEmpty()) {
+            tokens.append(QString::fromUcs4(token.constData(), token.size()));
+            token.clear();
+        }
+    }
+    if (!token.isEmpty())
+        tokens.append(QString::fromUcs4(token.constData(), token.size()));
+
+    return tokens;
+}
@@ -0,0 +1,32 @@
+#ifndef APPLEAPPSTOREQML_H
+#define APPLEAPPSTOREQML_H
+
+#include <QQmlEngine>
+
+#include "appleappstorebackend.h"
+#include "appleappstoreproduct.h"
+#include "storeproductlist.h"
+
+// The QML Store: the platform backend plus the list of products declared inside it
+class AppleAppStoreQml : public AppleAppStoreBackend
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(Store)
+
+    Q_PROPERTY(QQmlListProperty<AbstractProduct> productsQml READ productsQml NOTIFY productsChanged)
+    Q_CLASSINFO("DefaultProperty", "productsQml")
+
+public:
+    explicit AppleAppStoreQml(QObject * parent = nullptr) : AppleAppStoreBackend(parent) {}
+
+    QQmlListProperty<AbstractProduct> productsQml() { return storeProductList(this); }
+};
+
+struct AppleAppStoreProductForeign
+{
+    Q_GADGET
+    QML_FOREIGN(AppleAppStoreProduct)
+    QML_NAMED_ELEMENT(Product)
+};
+
+#endif // APPLEAPPSTOREQML_H
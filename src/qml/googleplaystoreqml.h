@@ -0,0 +1,32 @@
+#ifndef GOOGLEPLAYSTOREQML_H
+#define GOOGLEPLAYSTOREQML_H
+
+#include <QQmlEngine>
+
+#include "googleplaystorebackend.h"
+#include "googleplaystoreproduct.h"
+#include "storeproductlist.h"
+
+// The QML Store: the platform backend plus the list of products declared inside it
+class GooglePlayStoreQml : public GooglePlayStoreBackend
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(Store)
+
+    Q_PROPERTY(QQmlListProperty<AbstractProduct> productsQml READ productsQml NOTIFY productsChanged)
+    Q_CLASSINFO("DefaultProperty", "productsQml")
+
+public:
+    explicit GooglePlayStoreQml(QObject * parent = nullptr) : GooglePlayStoreBackend(parent) {}
+
+    QQmlListProperty<AbstractProduct> productsQml() { return storeProductList(this); }
+};
+
+struct GooglePlayStoreProductForeign
+{
+    Q_GADGET
+    QML_FOREIGN(GooglePlayStoreProduct)
+    QML_NAMED_ELEMENT(Product)
+};
+
+#endif // GOOGLEPLAYSTOREQML_H
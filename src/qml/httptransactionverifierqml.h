@@ -0,0 +1,15 @@
+#ifndef HTTPTRANSACTIONVERIFIERQML_H
+#define HTTPTRANSACTIONVERIFIERQML_H
+
+#include <QQmlEngine>
+
+#include <qt6purchasing/httptransactionverifier.h>
+
+struct HttpTransactionVerifierForeign
+{
+    Q_GADGET
+    QML_FOREIGN(HttpTransactionVerifier)
+    QML_NAMED_ELEMENT(HttpTransactionVerifier)
+};
+
+#endif // HTTPTRANSACTIONVERIFIERQML_H
@@ -0,0 +1,32 @@
+#ifndef MICROSOFTSTOREQML_H
+#define MICROSOFTSTOREQML_H
+
+#include <QQmlEngine>
+
+#include "microsoftstorebackend.h"
+#include "microsoftstoreproduct.h"
+#include "storeproductlist.h"
+
+// The QML Store: the platform backend plus the list of products declared inside it
+class MicrosoftStoreQml : public MicrosoftStoreBackend
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(Store)
+
+    Q_PROPERTY(QQmlListProperty<AbstractProduct> productsQml READ productsQml NOTIFY productsChanged)
+    Q_CLASSINFO("DefaultProperty", "productsQml")
+
+public:
+    explicit MicrosoftStoreQml(QObject * parent = nullptr) : MicrosoftStoreBackend(parent) {}
+
+    QQmlListProperty<AbstractProduct> productsQml() { return storeProductList(this); }
+};
+
+struct MicrosoftStoreProductForeign
+{
+    Q_GADGET
+    QML_FOREIGN(MicrosoftStoreProduct)
+    QML_NAMED_ELEMENT(Product)
+};
+
+#endif // MICROSOFTSTOREQML_H
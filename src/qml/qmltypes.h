@@ -0,0 +1,62 @@
+#ifndef QMLTYPES_H
+#define QMLTYPES_H
+
+#include <QQmlEngine>
+
+#include <qt6purchasing/abstractstorebackend.h>
+
+// QML registrations of the core types, which do not depend on Qt Qml themselves
+
+struct AbstractProductForeign
+{
+    Q_GADGET
+    QML_FOREIGN(AbstractProduct)
+    QML_NAMED_ELEMENT(AbstractProduct)
+    QML_UNCREATABLE("AbstractProduct is an abstract base class")
+};
+
+struct AbstractStoreBackendForeign
+{
+    Q_GADGET
+    QML_FOREIGN(AbstractStoreBackend)
+    QML_NAMED_ELEMENT(AbstractStoreBackend)
+    QML_UNCREATABLE("AbstractStoreBackend is an abstract base class")
+};
+
+struct TransactionVerifierForeign
+{
+    Q_GADGET
+    QML_FOREIGN(TransactionVerifier)
+    QML_NAMED_ELEMENT(TransactionVerifier)
+    QML_UNCREATABLE("TransactionVerifier is an abstract base class")
+};
+
+struct TransactionForeign
+{
+    Q_GADGET
+    QML_FOREIGN(Transaction)
+    QML_VALUE_TYPE(transaction)
+};
+
+struct FinalizeResultForeign
+{
+    Q_GADGET
+    QML_FOREIGN(FinalizeResult)
+    QML_VALUE_TYPE(finalizeResult)
+};
+
+struct TransactionRecordForeign
+{
+    Q_GADGET
+    QML_FOREIGN(TransactionRecord)
+    QML_VALUE_TYPE(transactionRecord)
+};
+
+struct StartupMilestonesForeign
+{
+    Q_GADGET
+    QML_FOREIGN(StartupMilestones)
+    QML_VALUE_TYPE(startupMilestones)
+};
+
+#endif // QMLTYPES_H
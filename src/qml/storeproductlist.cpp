@@ -0,0 +1,29 @@
+#include "storeproductlist.h"
+
+namespace {
+void appendProduct(QQmlListProperty<AbstractProduct> * list, AbstractProduct * product)
+{
+    if (product)
+        static_cast<AbstractStoreBackend *>(list->object)->adoptProduct(product);
+}
+
+qsizetype productCount(QQmlListProperty<AbstractProduct> * list)
+{
+    return static_cast<AbstractStoreBackend *>(list->object)->catalog().size();
+}
+
+AbstractProduct * productAt(QQmlListProperty<AbstractProduct> * list, qsizetype index)
+{
+    return static_cast<AbstractStoreBackend *>(list->object)->productForHandle(index);
+}
+
+void clearProducts(QQmlListProperty<AbstractProduct> * list)
+{
+    static_cast<AbstractStoreBackend *>(list->object)->clearProducts();
+}
+} // namespace
+
+QQmlListProperty<AbstractProduct> storeProductList(AbstractStoreBackend * store)
+{
+    return QQmlListProperty<AbstractProduct>(store, nullptr, &appendProduct, &productCount, &productAt, &clearProducts);
+}
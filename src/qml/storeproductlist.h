@@ -0,0 +1,11 @@
+#ifndef STOREPRODUCTLIST_H
+#define STOREPRODUCTLIST_H
+
+#include <QQmlListProperty>
+
+#include <qt6purchasing/abstractstorebackend.h>
+
+// The Store's default property in QML: products declared inside it, followed by those added from C++
+QQmlListProperty<AbstractProduct> storeProductList(AbstractStoreBackend * store);
+
+#endif // STOREPRODUCTLIST_H
@@ -0,0 +1,112 @@
+#include <qt6purchasing/ratelimiter.h>
+
+#include <cmath>
+#include <utility>
+
+RateLimiter::RateLimiter(int kinds) : _buckets(kinds)
+{
+    _timer.setSingleShot(true);
+    QObject::connect(&_timer, &QTimer::timeout, &_timer, [this]() { runWaiting(); });
+}
+
+void RateLimiter::setLimit(int kind, double perSecond, int burst)
+{
+    Bucket &bucket = _buckets[kind];
+    bucket.rate = qMax(0.0, perSecond);
+    bucket.burst = qMax(1, burst);
+    bucket.tokens = bucket.burst;
+    bucket.refilled.start();
+
+    // Waiting calls may now be allowed sooner, or straight away. They run from the event loop, since
+    // the caller may itself be one of the calls, or be mid-way through submitting one.
+    for (const Bucket &pending : std::as_const(_buckets)) {
+        if (!pending.waiting.empty()) {
+            _timer.start(0);
+            break;
+        }
+    }
+}
+
+void RateLimiter::submit(int kind, Call call, Call shed)
+{
+    Bucket &bucket = _buckets[kind];
+    if (bucket.rate <= 0) {
+        ++bucket.counters.admitted;
+        call();
+        return;
+    }
+
+    // Calls already waiting go first
+    refill(bucket);
+    if (bucket.waiting.empty() && bucket.tokens >= 1) {
+        bucket.tokens -= 1;
+        ++bucket.counters.admitted;
+        call();
+        return;
+    }
+
+    if (static_cast<int>(bucket.waiting.size()) >= _maxQueued) {
+        ++bucket.counters.shed;
+        if (shed)
+            shed();
+        return;
+    }
+
+    ++bucket.counters.delayed;
+    bucket.waiting.push_back(std::move(call));
+    if (!_timer.isActive() && !_running)
+        runWaiting();
+}
+
+RateLimiter::Counters RateLimiter::counters(int kind) const
+{
+    Counters counters = _buckets.at(kind).counters;
+    counters.queued = static_cast<qsizetype>(_buckets.at(kind).waiting.size());
+    return counters;
+}
+
+void RateLimiter::refill(Bucket &bucket)
+{
+    if (!bucket.refilled.isValid()) {
+        bucket.refilled.start();
+        return;
+    }
+    const qint64 elapsed = bucket.refilled.restart();
+    bucket.tokens = qMin(double(bucket.burst), bucket.tokens + elapsed * bucket.rate / 1000.0);
+}
+
+void RateLimiter::runWaiting()
+{
+    _running = true;
+    for (Bucket &bucket : _buckets) {
+        if (bucket.waiting.empty())
+            continue;
+
+        refill(bucket);
+        // Unlimited again: let everything through
+        while (!bucket.waiting.empty() && (bucket.rate <= 0 || bucket.tokens >= 1)) {
+            if (bucket.rate > 0)
+                bucket.tokens -= 1;
+            // Taken off the queue first, since the call may submit more
+            const Call call = std::move(bucket.waiting.front());
+            bucket.waiting.pop_front();
+            call();
+        }
+    }
+    _running = false;
+
+    // Calls may have queued more, in any bucket
+    qint64 nextToken = -1;
+    for (const Bucket &bucket : _buckets) {
+        if (!bucket.waiting.empty()) {
+            const qint64 wait = static_cast<qint64>(std::ceil((1 - bucket.tokens) * 1000.0 / bucket.rate));
+            if (nextToken < 0 || wait < nextToken)
+                nextToken = wait;
+        }
+    }
+
+    if (nextToken >= 0)
+        _timer.start(static_cast<int>(qMax<qint64>(1, nextToken)));
+    else
+        _timer.stop();
+}
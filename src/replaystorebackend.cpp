@@ -0,0 +1,141 @@
+#include <qt6purchasing/replaystorebackend.h>
+#include <qt6purchasing/storelogging.h>
+
+ReplayStoreBackend::ReplayStoreBackend(QObject * parent) : AbstractStoreBackend(parent)
+{
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &ReplayStoreBackend::replayNext);
+}
+
+bool ReplayStoreBackend::load(const QString &fileName)
+{
+    _timer.stop();
+    _records = StoreRecorder::load(fileName);
+    _next = 0;
+    qCDebug(lcStore) << "Loaded" << _records.size() << "store record(s) for replay from" << fileName;
+    return !_records.isEmpty();
+}
+
+void ReplayStoreBackend::startConnection()
+{
+    _next = 0;
+    _clock.start();
+    scheduleNext();
+}
+
+void ReplayStoreBackend::registerProduct(const QString &identifier)
+{
+    // Registered when the log says so
+    qCDebug(lcStore) << "Replay: awaiting registration of" << identifier << "from the recording";
+}
+
+void ReplayStoreBackend::purchaseProduct(AbstractProduct * product)
+{
+    const QString identifier = product->identifier();
+    for (qsizetype i = _next; i < _records.size(); ++i) {
+        const StoreRecord &record = _records.at(i);
+        const bool purchased = (record.type == StoreRecord::PurchaseSucceeded
+                                || record.type == StoreRecord::PurchasePending)
+                               && record.transaction.productId == identifier;
+        const bool failed = record.type == StoreRecord::PurchaseFailed && record.productId == identifier;
+        if (purchased || failed) {
+            qCDebug(lcStore) << "Replay: purchase of" << identifier << "will complete as recorded";
+            return;
+        }
+    }
+
+    // Otherwise the purchase would stay in flight for good
+    qCWarning(lcStore) << "Replay: the recording has no outcome for a purchase of" << identifier;
+    emit purchaseFailed(
+        identifier, static_cast<int>(PurchaseError::NotRecorded), 0, "No purchase outcome in the recording"
+    );
+}
+
+void ReplayStoreBackend::consumePurchase(Transaction transaction)
+{
+    qCDebug(lcStore) << "Replay: ignoring consumption of" << transaction.orderId
+                     << "- outcomes come from the recording";
+}
+
+void ReplayStoreBackend::restorePurchasesImpl()
+{
+    qCDebug(lcStore) << "Replay: restore requested - outcomes come from the recording";
+}
+
+AbstractProduct * ReplayStoreBackend::createProduct(ProductCatalog::Handle handle)
+{
+    Q_UNUSED(handle)
+    return new ReplayStoreProduct();
+}
+
+void ReplayStoreBackend::scheduleNext()
+{
+    if (isFinished()) {
+        qCDebug(lcStore) << "Replay finished";
+        emit replayFinished();
+        return;
+    }
+
+    qint64 delayMs = 0;
+    if (_speed > 0) {
+        const qint64 dueNs = qint64(_records.at(_next).timestampUs * 1000 / _speed);
+        delayMs = qMax<qint64>(0, (dueNs - _clock.nsecsElapsed()) / 1000000);
+    }
+    _timer.start(int(delayMs));
+}
+
+void ReplayStoreBackend::replayNext()
+{
+    // Everything already due goes out in this iteration, as a burst would have
+    const qint64 elapsedNs = _clock.nsecsElapsed();
+    do {
+        replay(_records.at(_next++));
+    } while (!isFinished() && (_speed <= 0 || _records.at(_next).timestampUs * 1000 / _speed <= elapsedNs));
+
+    scheduleNext();
+}
+
+void ReplayStoreBackend::replay(const StoreRecord &record)
+{
+    switch (record.type) {
+    case StoreRecord::Connected:
+        setConnected(record.code);
+        break;
+    case StoreRecord::CanMakePurchases:
+        setCanMakePurchases(record.code);
+        break;
+    case StoreRecord::ProductRegistered: {
+        ProductCatalog::Handle handle = _catalog.handle(record.productId);
+        if (handle < 0)
+            handle = addProduct(record.productId, record.productType);
+        applyStoreData(handle, record.data, AbstractProduct::Registered);
+        if (AbstractProduct * product = _catalog.facade(handle))
+            emit productRegistered(product);
+    } break;
+    case StoreRecord::PurchaseSucceeded:
+        emit purchaseSucceeded(record.transaction);
+        break;
+    case StoreRecord::PurchasePending:
+        emit purchasePending(record.transaction);
+        break;
+    case StoreRecord::PurchaseRestored:
+        emit purchaseRestored(record.transaction);
+        break;
+    case StoreRecord::PurchaseFailed:
+        emit purchaseFailed(record.productId, record.code, record.platformCode, record.message);
+        break;
+    case StoreRecord::ConsumeSucceeded:
+        emit consumePurchaseSucceeded(record.transaction);
+        break;
+    case StoreRecord::ConsumeFailed:
+        emit consumePurchaseFailed(record.transaction);
+        break;
+    case StoreRecord::RestoreSucceeded:
+        emit restorePurchasesSucceeded(record.code);
+        break;
+    case StoreRecord::RestoreFailed:
+        emit restorePurchasesFailed(record.code, record.platformCode, record.message);
+        break;
+    }
+}
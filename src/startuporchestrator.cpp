@@ -0,0 +1,108 @@
+#include <qt6purchasing/startuporchestrator.h>
+#include <qt6purchasing/storelogging.h>
+#include <qt6purchasing/storetracer.h>
+
+#include <QDebug>
+
+void StartupOrchestrator::addStep(const QString &name, const QStringList &dependencies, Action action)
+{
+    for (const QString &dependency : dependencies)
+        Q_ASSERT_X(indexOf(dependency) >= 0, "StartupOrchestrator::addStep", "dependency added after its dependent");
+
+    Step step;
+    step.name = name;
+    step.dependencies = dependencies;
+    step.action = std::move(action);
+    _steps.append(step);
+}
+
+void StartupOrchestrator::start()
+{
+    startReadySteps();
+}
+
+void StartupOrchestrator::restart()
+{
+    for (Step &step : _steps) {
+        if (step.state == Running)
+            StoreTracer::endAsync("startup", step.name);
+        step.state = Waiting;
+    }
+    _finished = false;
+    startReadySteps();
+}
+
+void StartupOrchestrator::complete(const QString &name)
+{
+    const qsizetype index = indexOf(name);
+    if (index < 0 || _steps.at(index).state != Running)
+        return;
+
+    _steps[index].state = Complete;
+    StoreTracer::endAsync("startup", name);
+    startReadySteps();
+}
+
+bool StartupOrchestrator::isRunning(const QString &name) const
+{
+    const qsizetype index = indexOf(name);
+    return index >= 0 && _steps.at(index).state == Running;
+}
+
+bool StartupOrchestrator::isComplete(const QString &name) const
+{
+    const qsizetype index = indexOf(name);
+    return index >= 0 && _steps.at(index).state == Complete;
+}
+
+qsizetype StartupOrchestrator::indexOf(const QString &name) const
+{
+    for (qsizetype index = 0; index < _steps.size(); ++index) {
+        if (_steps.at(index).name == name)
+            return index;
+    }
+    return -1;
+}
+
+void StartupOrchestrator::startReadySteps()
+{
+    // An action may complete its step straight away; the outer call picks up what that unblocks
+    if (_starting)
+        return;
+
+    _starting = true;
+    bool started = true;
+    while (started) {
+        started = false;
+        for (qsizetype index = 0; index < _steps.size(); ++index) {
+            if (_steps.at(index).state != Waiting)
+                continue;
+
+            bool ready = true;
+            for (const QString &dependency : _steps.at(index).dependencies)
+                ready = ready && isComplete(dependency);
+            if (!ready)
+                continue;
+
+            qCDebug(lcStore) << "Startup: starting" << _steps.at(index).name;
+            _steps[index].state = Running;
+            StoreTracer::beginAsync("startup", _steps.at(index).name);
+            // Copied, since the action may add to or complete steps
+            const Action action = _steps.at(index).action;
+            if (action)
+                action();
+            started = true;
+        }
+    }
+    _starting = false;
+
+    if (_finished)
+        return;
+    for (const Step &step : _steps) {
+        if (step.state != Complete)
+            return;
+    }
+    _finished = true;
+    if (_onFinished)
+        _onFinished();
+}
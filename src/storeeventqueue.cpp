@@ -0,0 +1,148 @@
+#include <qt6purchasing/storeeventqueue.h>
+#include <qt6purchasing/storetracer.h>
+
+#include <QMetaObject>
+#include <QThread>
+
+#include <utility>
+
+namespace {
+// Bounds the time spent in one event loop iteration; the rest follow in the next one
+constexpr int MaxEventsPerDrain = 256;
+} // namespace
+
+StoreEventQueue::~StoreEventQueue()
+{
+    stopDecodeThread();
+}
+
+void StoreEventQueue::post(StoreEvent event)
+{
+    // Recorded on the platform's callback thread
+    StoreTracer::instant("platform callback", event.transaction.orderId);
+    _posted.push(std::move(event));
+
+    // Checked after the push: if the worker is stopped in between, the receiver drains what it left
+    if (_background.load(std::memory_order_acquire)) {
+        if (_decodeWakeupPending.exchange(true, std::memory_order_acq_rel) || scheduleDecode())
+            return;
+        // The worker has just been stopped; the receiver takes the event instead
+    }
+
+    // Only the first event after a drain started needs to wake the receiver
+    if (!_wakeupPending.exchange(true, std::memory_order_acq_rel))
+        scheduleDrain();
+}
+
+void StoreEventQueue::setDecodeInBackground(bool background)
+{
+    if (decodesInBackground() == background)
+        return;
+
+    if (background) {
+        auto * thread = new QThread;
+        thread->setObjectName("StoreEventDecoder");
+        auto * context = new QObject;
+        context->moveToThread(thread);
+        thread->start();
+        {
+            QMutexLocker locker(&_decodeMutex);
+            _decodeThread = thread;
+            _decodeContext = context;
+        }
+
+        // The receiver stops taking from _posted before the worker starts
+        _background.store(true, std::memory_order_release);
+        _decodeWakeupPending.store(true, std::memory_order_release);
+        scheduleDecode();
+        return;
+    }
+
+    _background.store(false, std::memory_order_release);
+    stopDecodeThread();
+
+    // The receiver is the only consumer again; pick up whatever the worker left behind
+    if (!_wakeupPending.exchange(true, std::memory_order_acq_rel))
+        scheduleDrain();
+}
+
+void StoreEventQueue::stopDecodeThread()
+{
+    QThread * thread = nullptr;
+    QObject * context = nullptr;
+    {
+        // Producers stop scheduling on the worker from here on
+        QMutexLocker locker(&_decodeMutex);
+        thread = std::exchange(_decodeThread, nullptr);
+        context = std::exchange(_decodeContext, nullptr);
+    }
+    if (!thread)
+        return;
+
+    thread->quit();
+    thread->wait();
+    delete context;
+    delete thread;
+    _decodeWakeupPending.store(false, std::memory_order_release);
+}
+
+bool StoreEventQueue::scheduleDecode()
+{
+    // Producers call this from any thread while the receiver may be stopping the worker
+    QMutexLocker locker(&_decodeMutex);
+    if (!_decodeContext)
+        return false;
+    QMetaObject::invokeMethod(_decodeContext, [this]() { decode(); }, Qt::QueuedConnection);
+    return true;
+}
+
+void StoreEventQueue::decode()
+{
+    // Same pattern as drain(), on the worker thread
+    _decodeWakeupPending.store(false, std::memory_order_release);
+
+    StoreEvent event;
+    int decoded = 0;
+    StoreTraceSpan span("decode store events");
+    while (decoded < MaxEventsPerDrain && _posted.pop(event)) {
+        if (_decoder)
+            _decoder(event);
+        event.decoded = true;
+        _events.push(std::move(event));
+        ++decoded;
+    }
+
+    if (decoded > 0 && !_wakeupPending.exchange(true, std::memory_order_acq_rel))
+        scheduleDrain();
+    if (decoded == MaxEventsPerDrain && !_decodeWakeupPending.exchange(true, std::memory_order_acq_rel))
+        scheduleDecode();
+}
+
+void StoreEventQueue::scheduleDrain()
+{
+    QMetaObject::invokeMethod(_receiver, [this]() { drain(); }, Qt::QueuedConnection);
+}
+
+void StoreEventQueue::drain()
+{
+    // Cleared before popping: an event pushed from now on schedules another drain
+    _wakeupPending.store(false, std::memory_order_release);
+
+    StoreEvent event;
+    int handled = 0;
+    StoreTraceSpan span("drain store events");
+    while (handled < MaxEventsPerDrain) {
+        // A handler may turn background decoding on, so this is checked for every event
+        if (!_events.pop(event) && (_background.load(std::memory_order_acquire) || !_posted.pop(event)))
+            break;
+
+        if (!event.decoded && _decoder)
+            _decoder(event);
+        StoreTraceSpan handling("handle store event", event.transaction.orderId);
+        _handler(event);
+        ++handled;
+    }
+
+    if (handled == MaxEventsPerDrain && !_wakeupPending.exchange(true, std::memory_order_acq_rel))
+        scheduleDrain();
+}
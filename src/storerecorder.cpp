@@ -0,0 +1,248 @@
+#include <qt6purchasing/storerecorder.h>
+#include <qt6purchasing/storelogging.h>
+
+#include <QDataStream>
+
+namespace {
+constexpr quint32 RecordingMagic = 0x4c525051; // "QPRL"
+constexpr quint32 FormatVersion = 1;
+constexpr int StreamVersion = QDataStream::Qt_6_0;
+
+QDataStream &operator<<(QDataStream &stream, const Transaction &transaction)
+{
+    return stream << transaction.orderId << transaction.productId << transaction.purchaseToken;
+}
+
+QDataStream &operator>>(QDataStream &stream, Transaction &transaction)
+{
+    return stream >> transaction.orderId >> transaction.productId >> transaction.purchaseToken;
+}
+
+// Only the fields a record type uses are written
+void writeRecord(QDataStream &stream, const StoreRecord &record)
+{
+    stream << record.timestampUs << quint8(record.type);
+    switch (record.type) {
+    case StoreRecord::Connected:
+    case StoreRecord::CanMakePurchases:
+    case StoreRecord::RestoreSucceeded:
+        stream << qint32(record.code);
+        break;
+    case StoreRecord::ProductRegistered:
+        stream << record.productId << quint8(record.productType) << record.data.title << record.data.description
+               << record.data.price << record.data.priceMicros << record.data.currencyCode;
+        break;
+    case StoreRecord::PurchaseSucceeded:
+    case StoreRecord::PurchasePending:
+    case StoreRecord::PurchaseRestored:
+    case StoreRecord::ConsumeSucceeded:
+    case StoreRecord::ConsumeFailed:
+        stream << record.transaction;
+        break;
+    case StoreRecord::PurchaseFailed:
+        stream << record.productId << qint32(record.code) << qint32(record.platformCode) << record.message;
+        break;
+    case StoreRecord::RestoreFailed:
+        stream << qint32(record.code) << qint32(record.platformCode) << record.message;
+        break;
+    }
+}
+
+bool readRecord(QDataStream &stream, StoreRecord &record)
+{
+    quint8 type = 0;
+    qint32 code = 0;
+    qint32 platformCode = 0;
+    quint8 productType = 0;
+
+    stream >> record.timestampUs >> type;
+    record.type = static_cast<StoreRecord::Type>(type);
+    switch (record.type) {
+    case StoreRecord::Connected:
+    case StoreRecord::CanMakePurchases:
+    case StoreRecord::RestoreSucceeded:
+        stream >> code;
+        break;
+    case StoreRecord::ProductRegistered:
+        stream >> record.productId >> productType >> record.data.title >> record.data.description
+            >> record.data.price >> record.data.priceMicros >> record.data.currencyCode;
+        record.productType = static_cast<AbstractProduct::ProductType>(productType);
+        break;
+    case StoreRecord::PurchaseSucceeded:
+    case StoreRecord::PurchasePending:
+    case StoreRecord::PurchaseRestored:
+    case StoreRecord::ConsumeSucceeded:
+    case StoreRecord::ConsumeFailed:
+        stream >> record.transaction;
+        break;
+    case StoreRecord::PurchaseFailed:
+        stream >> record.productId >> code >> platformCode >> record.message;
+        break;
+    case StoreRecord::RestoreFailed:
+        stream >> code >> platformCode >> record.message;
+        break;
+    default:
+        return false;
+    }
+    record.code = code;
+    record.platformCode = platformCode;
+    return stream.status() == QDataStream::Ok;
+}
+} // namespace
+
+StoreRecorder::StoreRecorder(AbstractStoreBackend * store, QObject * parent) : QObject(parent), _store(store) {}
+
+bool StoreRecorder::start(const QString &fileName)
+{
+    stop();
+    if (!_store)
+        return false;
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcStore) << "Failed to open store recording" << fileName << _file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&_file);
+    stream.setVersion(StreamVersion);
+    stream << RecordingMagic << FormatVersion;
+    _clock.start();
+
+    AbstractStoreBackend * store = _store;
+    auto record = [this](StoreRecord::Type type) {
+        StoreRecord r;
+        r.type = type;
+        return r;
+    };
+
+    // The state the store is in already, so a replay starts from the same point
+    StoreRecord connected = record(StoreRecord::Connected);
+    connected.code = store->isConnected();
+    write(connected);
+
+    _connections << connect(store, &AbstractStoreBackend::connectedChanged, this, [this, store, record]() {
+        StoreRecord r = record(StoreRecord::Connected);
+        r.code = store->isConnected();
+        write(r);
+    });
+    _connections << connect(store, &AbstractStoreBackend::canMakePurchasesChanged, this, [this, store, record]() {
+        StoreRecord r = record(StoreRecord::CanMakePurchases);
+        r.code = store->canMakePurchases();
+        write(r);
+    });
+    _connections << connect(store, &AbstractStoreBackend::productRegistered, this, [this, record](AbstractProduct * p) {
+        StoreRecord r = record(StoreRecord::ProductRegistered);
+        r.productId = p->identifier();
+        r.productType = p->productType();
+        r.data = p->storeData();
+        write(r);
+    });
+
+    const auto transactionRecorder = [this, record](StoreRecord::Type type) {
+        return [this, record, type](Transaction transaction) {
+            StoreRecord r = record(type);
+            r.transaction = transaction;
+            write(r);
+        };
+    };
+    _connections << connect(
+        store, &AbstractStoreBackend::purchaseSucceeded, this, transactionRecorder(StoreRecord::PurchaseSucceeded)
+    );
+    _connections << connect(
+        store, &AbstractStoreBackend::purchasePending, this, transactionRecorder(StoreRecord::PurchasePending)
+    );
+    _connections << connect(
+        store, &AbstractStoreBackend::purchaseRestored, this, transactionRecorder(StoreRecord::PurchaseRestored)
+    );
+    _connections << connect(
+        store, &AbstractStoreBackend::consumePurchaseSucceeded, this, transactionRecorder(StoreRecord::ConsumeSucceeded)
+    );
+    _connections << connect(
+        store, &AbstractStoreBackend::consumePurchaseFailed, this, transactionRecorder(StoreRecord::ConsumeFailed)
+    );
+
+    _connections << connect(
+        store,
+        &AbstractStoreBackend::purchaseFailed,
+        this,
+        [this, record](const QString &productId, int error, int platformCode, const QString &message) {
+            StoreRecord r = record(StoreRecord::PurchaseFailed);
+            r.productId = productId;
+            r.code = error;
+            r.platformCode = platformCode;
+            r.message = message;
+            write(r);
+        }
+    );
+    _connections << connect(store, &AbstractStoreBackend::restorePurchasesSucceeded, this, [this, record](int count) {
+        StoreRecord r = record(StoreRecord::RestoreSucceeded);
+        r.code = count;
+        write(r);
+    });
+    _connections << connect(
+        store,
+        &AbstractStoreBackend::restorePurchasesFailed,
+        this,
+        [this, record](int error, int platformCode, const QString &message) {
+            StoreRecord r = record(StoreRecord::RestoreFailed);
+            r.code = error;
+            r.platformCode = platformCode;
+            r.message = message;
+            write(r);
+        }
+    );
+
+    qCDebug(lcStore) << "Recording store callbacks to" << fileName;
+    return true;
+}
+
+void StoreRecorder::stop()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(_connections))
+        disconnect(connection);
+    _connections.clear();
+    _file.close();
+}
+
+void StoreRecorder::write(StoreRecord record)
+{
+    record.timestampUs = _clock.nsecsElapsed() / 1000;
+
+    QDataStream stream(&_file);
+    stream.setVersion(StreamVersion);
+    writeRecord(stream, record);
+
+    // Kept on disk as it happens: the sequences worth replaying often end in a crash
+    _file.flush();
+}
+
+QList<StoreRecord> StoreRecorder::load(const QString &fileName)
+{
+    QList<StoreRecord> records;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(lcStore) << "Failed to open store recording" << fileName << file.errorString();
+        return records;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(StreamVersion);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != RecordingMagic || version != FormatVersion) {
+        qCWarning(lcStore) << "Unsupported store recording" << fileName;
+        return records;
+    }
+
+    // A recording cut short by a crash ends in a partial record, which is dropped
+    while (!stream.atEnd()) {
+        StoreRecord record;
+        if (!readRecord(stream, record))
+            break;
+        records.append(record);
+    }
+    return records;
+}
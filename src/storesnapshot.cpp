@@ -0,0 +1,149 @@
+#include <qt6purchasing/storesnapshot.h>
+#include <qt6purchasing/storelogging.h>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+namespace {
+constexpr quint32 SnapshotMagic = 0x53535051; // "QPSS"
+constexpr quint32 FormatVersion = 1;
+constexpr qint64 HeaderSize = 12; // magic, version, product count
+
+// Per product: priceMicros, type, status, padding, first string character, six string lengths
+constexpr qint64 EntrySize = 40;
+constexpr int StringCount = 6;
+
+enum StringField { Identifier, MicrosoftStoreId, Title, Description, Price, CurrencyCode };
+} // namespace
+
+bool StoreSnapshot::load(const QString &fileName)
+{
+    _products.clear();
+
+    QFile file(fileName);
+    if (!file.exists())
+        return false;
+    if (!file.open(QIODevice::ReadOnly) || file.size() < HeaderSize) {
+        qCWarning(lcStore) << "Failed to open store snapshot" << fileName;
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar * bytes = file.map(0, size);
+    if (!bytes) {
+        qCWarning(lcStore) << "Failed to map store snapshot" << fileName << file.errorString();
+        return false;
+    }
+
+    const quint32 count = qFromLittleEndian<quint32>(bytes + 8);
+    const qint64 stringsOffset = HeaderSize + qint64(count) * EntrySize;
+    if (qFromLittleEndian<quint32>(bytes) != SnapshotMagic || qFromLittleEndian<quint32>(bytes + 4) != FormatVersion
+        || stringsOffset > size) {
+        qCWarning(lcStore) << "Ignoring unsupported store snapshot" << fileName;
+        file.unmap(const_cast<uchar *>(bytes));
+        return false;
+    }
+
+    const qint64 stringChars = (size - stringsOffset) / 2;
+    const uchar * strings = bytes + stringsOffset;
+    _products.reserve(count);
+
+    for (quint32 i = 0; i < count; ++i) {
+        const uchar * entry = bytes + HeaderSize + qint64(i) * EntrySize;
+        qint64 position = qFromLittleEndian<quint32>(entry + 12);
+
+        QString fields[StringCount];
+        bool valid = true;
+        for (int field = 0; field < StringCount && valid; ++field) {
+            const qint64 length = qFromLittleEndian<quint32>(entry + 16 + field * 4);
+            valid = position + length <= stringChars;
+            if (valid) {
+                fields[field] = QString(length, Qt::Uninitialized);
+                qFromLittleEndian<quint16>(strings + position * 2, length, fields[field].data());
+            }
+            position += length;
+        }
+        if (!valid) {
+            qCWarning(lcStore) << "Store snapshot" << fileName << "is truncated - ignoring it";
+            _products.clear();
+            break;
+        }
+
+        Product product;
+        product.type = static_cast<AbstractProduct::ProductType>(entry[8]);
+        product.microsoftStoreId = fields[MicrosoftStoreId];
+        product.data.title = fields[Title];
+        product.data.description = fields[Description];
+        product.data.price = fields[Price];
+        product.data.priceMicros = qFromLittleEndian<qint64>(entry);
+        product.data.currencyCode = fields[CurrencyCode];
+        _products.insert(fields[Identifier], product);
+    }
+
+    // Decoded up front so the file can be replaced by the next checkpoint
+    file.unmap(const_cast<uchar *>(bytes));
+    qCDebug(lcStore) << "Loaded store snapshot with" << _products.size() << "product(s)";
+    return !_products.isEmpty();
+}
+
+bool StoreSnapshot::save(const QString &fileName, const ProductCatalog &catalog)
+{
+    QByteArray entries;
+    QByteArray strings;
+    quint32 count = 0;
+    quint32 stringChars = 0;
+
+    for (ProductCatalog::Handle handle = 0; handle < catalog.size(); ++handle) {
+        if (catalog.status(handle) != AbstractProduct::Registered || catalog.identifier(handle).isEmpty())
+            continue;
+
+        const ProductStoreData data = catalog.storeData(handle);
+        const QString fields[StringCount] = {
+            catalog.identifier(handle),
+            catalog.microsoftStoreId(handle),
+            data.title,
+            data.description,
+            data.price,
+            data.currencyCode
+        };
+
+        uchar entry[EntrySize] = {};
+        qToLittleEndian<qint64>(data.priceMicros, entry);
+        entry[8] = static_cast<uchar>(catalog.productType(handle));
+        entry[9] = static_cast<uchar>(AbstractProduct::Registered);
+        qToLittleEndian<quint32>(stringChars, entry + 12);
+        for (int field = 0; field < StringCount; ++field) {
+            const QString &value = fields[field];
+            qToLittleEndian<quint32>(static_cast<quint32>(value.size()), entry + 16 + field * 4);
+            const qsizetype offset = strings.size();
+            strings.resize(offset + value.size() * 2);
+            qToLittleEndian<quint16>(value.utf16(), value.size(), strings.data() + offset);
+            stringChars += static_cast<quint32>(value.size());
+        }
+        entries.append(reinterpret_cast<const char *>(entry), EntrySize);
+        ++count;
+    }
+
+    uchar header[HeaderSize];
+    qToLittleEndian(SnapshotMagic, header);
+    qToLittleEndian(FormatVersion, header + 4);
+    qToLittleEndian(count, header + 8);
+
+    // Written beside the old snapshot and renamed over it, so a crash never leaves half a file
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcStore) << "Failed to write store snapshot" << fileName << file.errorString();
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(header), HeaderSize);
+    file.write(entries);
+    file.write(strings);
+    return file.commit();
+}
+
+const StoreSnapshot::Product * StoreSnapshot::find(const QString &identifier) const
+{
+    auto it = _products.constFind(identifier);
+    return it != _products.constEnd() ? &*it : nullptr;
+}
@@ -0,0 +1,211 @@
+#include <qt6purchasing/storetracer.h>
+#include <qt6purchasing/storelogging.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> StoreTracer::s_enabled{false};
+
+namespace {
+struct TraceEvent
+{
+    qint64 timestampNs;
+    const char * name;
+    QString id;
+    char phase;
+};
+
+// A ring: once full, each event overwrites the oldest
+struct ThreadBuffer
+{
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[StoreTracer::BufferCapacity]};
+    quint64 written = 0; // events ever recorded; guarded by lock
+    // Taken by the owning thread for each event, so it is only ever contended during an export
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::atomic<bool> retired{false};
+    quintptr threadId = 0;
+    quint64 first = 0; // first event of the next export; guarded by the registry mutex
+};
+
+class BufferLocker
+{
+public:
+    explicit BufferLocker(ThreadBuffer * buffer) : _buffer(buffer)
+    {
+        while (_buffer->lock.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+    ~BufferLocker() { _buffer->lock.clear(std::memory_order_release); }
+
+    BufferLocker(const BufferLocker &) = delete;
+    BufferLocker &operator=(const BufferLocker &) = delete;
+
+private:
+    ThreadBuffer * _buffer;
+};
+
+// Buffers outlive their threads until the next clear(), so a trace still covers finished workers
+struct Registry
+{
+    QMutex mutex;
+    std::vector<ThreadBuffer *> buffers;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadBufferHandle
+{
+    ThreadBuffer * buffer = nullptr;
+    ~ThreadBufferHandle()
+    {
+        if (buffer)
+            buffer->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadBufferHandle t_buffer;
+
+ThreadBuffer * threadBuffer()
+{
+    if (!t_buffer.buffer) {
+        auto * buffer = new ThreadBuffer;
+        buffer->threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        QMutexLocker locker(&registry().mutex);
+        registry().buffers.push_back(buffer);
+        t_buffer.buffer = buffer;
+    }
+    return t_buffer.buffer;
+}
+
+qint64 now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+QString s_traceFile;
+
+void writeTraceOnExit()
+{
+    if (!StoreTracer::writeChromeTrace(s_traceFile))
+        qCWarning(lcStore) << "Failed to write store trace to" << s_traceFile;
+}
+
+void enableFromEnvironment()
+{
+    s_traceFile = qEnvironmentVariable("QT6PURCHASING_TRACE");
+    if (s_traceFile.isEmpty())
+        return;
+
+    qCDebug(lcStore) << "Store tracing enabled - writing to" << s_traceFile << "on exit";
+    StoreTracer::setEnabled(true);
+    qAddPostRoutine(writeTraceOnExit);
+}
+} // namespace
+
+Q_COREAPP_STARTUP_FUNCTION(enableFromEnvironment)
+
+void StoreTracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void StoreTracer::record(char phase, const char * name, const QString &id)
+{
+    ThreadBuffer * buffer = threadBuffer();
+    const qint64 timestampNs = now();
+
+    BufferLocker locker(buffer);
+    TraceEvent &event = buffer->events[buffer->written % BufferCapacity];
+    event.timestampNs = timestampNs;
+    event.name = name;
+    event.id = id;
+    event.phase = phase;
+    ++buffer->written;
+}
+
+bool StoreTracer::writeChromeTrace(const QString &fileName)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    {
+        QMutexLocker locker(&registry().mutex);
+        std::vector<TraceEvent> events;
+        for (ThreadBuffer * buffer : registry().buffers) {
+            // Copied out so the owning thread is held up only briefly
+            quint64 overwritten = 0;
+            {
+                BufferLocker bufferLocker(buffer);
+                const quint64 oldest = buffer->written > quint64(BufferCapacity) ? buffer->written - BufferCapacity : 0;
+                const quint64 begin = std::max(buffer->first, oldest);
+                overwritten = begin - buffer->first;
+                events.clear();
+                events.reserve(buffer->written - begin);
+                for (quint64 i = begin; i < buffer->written; ++i)
+                    events.push_back(buffer->events[i % BufferCapacity]);
+            }
+            if (overwritten > 0)
+                qCWarning(lcStore) << "Store trace of thread" << buffer->threadId << "lost its" << overwritten
+                                   << "oldest event(s) - export or clear() more often";
+
+            for (const TraceEvent &event : events) {
+                QJsonObject entry;
+                entry["name"] = QString::fromLatin1(event.name);
+                entry["cat"] = "qt6purchasing";
+                entry["ph"] = QString(QLatin1Char(event.phase));
+                entry["ts"] = double(event.timestampNs) / 1000.0; // microseconds
+                entry["pid"] = pid;
+                entry["tid"] = qint64(buffer->threadId);
+                if (event.phase == 'b' || event.phase == 'e')
+                    entry["id"] = event.id;
+                else if (event.phase == 'i')
+                    entry["s"] = "t";
+                if (!event.id.isEmpty())
+                    entry["args"] = QJsonObject{{"id", event.id}};
+                traceEvents.append(entry);
+            }
+        }
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QJsonObject trace;
+    trace["traceEvents"] = traceEvents;
+    trace["displayTimeUnit"] = "ms";
+    return file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+void StoreTracer::clear()
+{
+    QMutexLocker locker(&registry().mutex);
+    auto &buffers = registry().buffers;
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        ThreadBuffer * buffer = *it;
+        if (buffer->retired.load(std::memory_order_acquire)) {
+            delete buffer;
+            it = buffers.erase(it);
+        } else {
+            BufferLocker bufferLocker(buffer);
+            buffer->first = buffer->written;
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,345 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+
+#include "teststorebackend.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include <malloc.h>
+
+// Counts every heap allocation: operator new for objects, and the C allocator for the storage
+// of Qt's strings and containers. glibc lets an executable replace malloc by defining it.
+// Retained bytes are the usable size of blocks still allocated, including allocator rounding.
+extern "C" {
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * pointer, size_t size);
+void __libc_free(void * pointer);
+}
+
+namespace {
+std::atomic<quint64> allocationCount{0};
+std::atomic<quint64> allocatedBytes{0};
+std::atomic<qint64> retainedBytes{0};
+
+void * counted(void * pointer, size_t size)
+{
+    if (pointer) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        retainedBytes.fetch_add(qint64(malloc_usable_size(pointer)), std::memory_order_relaxed);
+    }
+    return pointer;
+}
+
+void released(void * pointer)
+{
+    if (pointer)
+        retainedBytes.fetch_sub(qint64(malloc_usable_size(pointer)), std::memory_order_relaxed);
+}
+} // namespace
+
+extern "C" {
+void * malloc(size_t size) noexcept
+{
+    return counted(__libc_malloc(size), size);
+}
+
+void * calloc(size_t count, size_t size) noexcept
+{
+    return counted(__libc_calloc(count, size), count * size);
+}
+
+void * realloc(void * pointer, size_t size) noexcept
+{
+    const qint64 previous = pointer ? qint64(malloc_usable_size(pointer)) : 0;
+    void * resized = __libc_realloc(pointer, size);
+    if (resized || size == 0)
+        retainedBytes.fetch_sub(previous, std::memory_order_relaxed);
+    return counted(resized, size);
+}
+
+void free(void * pointer) noexcept
+{
+    released(pointer);
+    __libc_free(pointer);
+}
+}
+
+void * operator new(std::size_t size)
+{
+    void * pointer = counted(__libc_malloc(size ? size : 1), size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept
+{
+    free(pointer);
+}
+
+namespace {
+constexpr int Count = 10000;
+
+struct Measurement
+{
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+    qint64 retained = 0; // still allocated when the work is done
+    qint64 nsecs = 0;
+};
+
+// Includes work the calls defer to the event loop
+Measurement measure(const std::function<void()> &work)
+{
+    const quint64 allocations = allocationCount.load(std::memory_order_relaxed);
+    const quint64 bytes = allocatedBytes.load(std::memory_order_relaxed);
+    const qint64 retained = retainedBytes.load(std::memory_order_relaxed);
+    QElapsedTimer timer;
+    timer.start();
+
+    work();
+    QCoreApplication::processEvents();
+
+    Measurement result;
+    result.nsecs = timer.nsecsElapsed();
+    result.allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+    result.bytes = allocatedBytes.load(std::memory_order_relaxed) - bytes;
+    result.retained = retainedBytes.load(std::memory_order_relaxed) - retained;
+    return result;
+}
+
+void report(const char * name, const Measurement &measurement, int calls)
+{
+    std::printf(
+        "%-32s %12.1f %12.1f %12.1f %12.0f\n", name, double(measurement.allocations) / calls,
+        double(measurement.bytes) / calls, double(measurement.retained) / calls, double(measurement.nsecs) / calls
+    );
+}
+
+QString productId(int index)
+{
+    return QString("product-%1").arg(index);
+}
+
+ProductStoreData storeData(int index)
+{
+    ProductStoreData data;
+    data.title = QString("Product %1").arg(index);
+    data.description = "A product for the store benchmark";
+    data.price = "$1.99";
+    data.priceMicros = 1990000;
+    data.currencyCode = "USD";
+    return data;
+}
+
+// A store with count products, each registered and with its product object created as QML would
+void populate(TestStoreBackend &store, AbstractProduct::ProductType type, int count)
+{
+    store.reserveProducts(count);
+    for (int i = 0; i < count; ++i)
+        store.addProduct(productId(i), type);
+    store.setConnected(true);
+    store.registered.clear();
+    for (int i = 0; i < count; ++i) {
+        store.applyStoreData(i, storeData(i), AbstractProduct::Registered);
+        store.productForHandle(i);
+    }
+    QCoreApplication::processEvents();
+}
+
+// Products as catalog rows, with and without their objects, against one object per product
+void benchmarkCatalog()
+{
+    QStringList identifiers;
+    for (int i = 0; i < Count; ++i)
+        identifiers.append(productId(i));
+
+    {
+        TestStoreBackend store;
+        const Measurement measurement = measure([&]() {
+            for (int i = 0; i < Count; ++i)
+                store.addProduct(identifiers.at(i), AbstractProduct::Consumable);
+        });
+        report("catalog row", measurement, Count);
+    }
+    {
+        TestStoreBackend store;
+        const Measurement measurement = measure([&]() {
+            for (int i = 0; i < Count; ++i)
+                store.productForHandle(store.addProduct(identifiers.at(i), AbstractProduct::Consumable));
+        });
+        report("catalog row with its object", measurement, Count);
+    }
+    {
+        TestStoreBackend store;
+        const Measurement measurement = measure([&]() {
+            for (int i = 0; i < Count; ++i) {
+                auto * product = new TestStoreProduct(&store);
+                product->setIdentifier(identifiers.at(i));
+                product->setProductType(AbstractProduct::Consumable);
+                store.adoptProduct(product);
+            }
+        });
+        report("adopted product object", measurement, Count);
+    }
+}
+
+int registeredCount(TestStoreBackend &store)
+{
+    int registered = 0;
+    for (int i = 0; i < Count; ++i)
+        registered += store.productForHandle(i)->status() == AbstractProduct::Registered;
+    return registered;
+}
+
+// From construction until every product has data to show. The test store answers at once, so the
+// cold figure leaves out the platform round trip that a warm start also hides.
+void benchmarkStartup()
+{
+    QTemporaryDir directory;
+    const QString snapshotPath = directory.filePath("store.snapshot");
+    {
+        TestStoreBackend store;
+        populate(store, AbstractProduct::Consumable, Count);
+        store.setSnapshotPath(snapshotPath);
+        store.saveSnapshot();
+    }
+
+    QStringList identifiers;
+    for (int i = 0; i < Count; ++i)
+        identifiers.append(productId(i));
+
+    {
+        TestStoreBackend store;
+        const Measurement measurement = measure([&]() {
+            store.reserveProducts(Count);
+            for (const QString &identifier : std::as_const(identifiers))
+                store.addProduct(identifier, AbstractProduct::Consumable);
+            store.setConnected(true);
+            store.registerAll();
+        });
+        report("cold start, per product", measurement, Count);
+        if (registeredCount(store) != Count)
+            std::printf("  cold start left products unregistered\n");
+    }
+    {
+        TestStoreBackend store;
+        const Measurement measurement = measure([&]() {
+            store.setSnapshotPath(snapshotPath);
+            store.reserveProducts(Count);
+            for (const QString &identifier : std::as_const(identifiers))
+                store.addProduct(identifier, AbstractProduct::Consumable);
+        });
+        report("warm start, per product", measurement, Count);
+        if (registeredCount(store) != Count)
+            std::printf("  warm start left products without snapshot data\n");
+    }
+}
+
+void benchmarkRouting()
+{
+    TestStoreBackend store;
+    populate(store, AbstractProduct::Consumable, 1);
+    store.enableProcessing();
+
+    QList<Transaction> transactions;
+    for (int i = 0; i < Count; ++i) {
+        Transaction transaction;
+        transaction.orderId = QString("order-%1").arg(i);
+        transaction.productId = productId(0);
+        transaction.purchaseToken = QString("token-%1").arg(i);
+        transactions.append(transaction);
+    }
+
+    const Measurement measurement = measure([&]() {
+        for (const Transaction &transaction : std::as_const(transactions))
+            emit store.purchaseSucceeded(transaction);
+    });
+    report("routed purchase", measurement, Count);
+}
+
+void benchmarkRegistration()
+{
+    TestStoreBackend store;
+    store.reserveProducts(Count);
+    for (int i = 0; i < Count; ++i)
+        store.addProduct(productId(i), AbstractProduct::Consumable);
+    store.setConnected(true);
+
+    QList<ProductStoreData> data;
+    for (int i = 0; i < Count; ++i)
+        data.append(storeData(i));
+
+    const Measurement measurement = measure([&]() {
+        for (int i = 0; i < Count; ++i)
+            store.applyStoreData(i, data.at(i), AbstractProduct::Registered);
+    });
+    report("registration", measurement, Count);
+}
+
+void benchmarkRestore()
+{
+    TestStoreBackend store;
+    populate(store, AbstractProduct::Unlockable, Count);
+    store.enableProcessing();
+
+    QList<Transaction> transactions;
+    for (int i = 0; i < Count; ++i) {
+        Transaction transaction;
+        transaction.orderId = QString("order-%1").arg(i);
+        transaction.productId = productId(i);
+        transactions.append(transaction);
+    }
+
+    const Measurement measurement = measure([&]() {
+        for (const Transaction &transaction : std::as_const(transactions))
+            emit store.purchaseRestored(transaction);
+    });
+    report("restore item", measurement, Count);
+}
+} // namespace
+
+// Heap allocations, bytes allocated and time per call on the store's hot paths
+int main(int argc, char * argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Measure the paths themselves rather than debug output
+    QLoggingCategory::setFilterRules("qt6purchasing.store.debug=false");
+
+    std::printf("%-32s %12s %12s %12s %12s\n", "per call", "allocations", "bytes", "retained", "ns");
+    benchmarkCatalog();
+    benchmarkStartup();
+    benchmarkRouting();
+    benchmarkRegistration();
+    benchmarkRestore();
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef TESTSTOREBACKEND_H
+#define TESTSTOREBACKEND_H
+
+#include <QList>
+#include <QStringList>
+
+#include <utility>
+
+#include <qt6purchasing/abstractstorebackend.h>
+
+class TestStoreProduct : public AbstractProduct
+{
+    Q_OBJECT
+
+public:
+    explicit TestStoreProduct(QObject * parent = nullptr) : AbstractProduct(parent) {}
+};
+
+// A store that records the calls made to it. Tests answer them through the same protected
+// calls and signals a platform backend would use.
+class TestStoreBackend : public AbstractStoreBackend
+{
+    Q_OBJECT
+
+public:
+    explicit TestStoreBackend(QObject * parent = nullptr) : AbstractStoreBackend(parent) {}
+
+    void startConnection() override { setConnected(true); }
+    void registerProduct(const QString &identifier) override { registered.append(identifier); }
+    void purchaseProduct(AbstractProduct * product) override { purchased.append(product->identifier()); }
+    void consumePurchase(Transaction transaction) override { consumed.append(transaction); }
+    bool canMakePurchases() const override { return isConnected(); }
+
+    using AbstractStoreBackend::applyStoreData;
+    using AbstractStoreBackend::setConnected;
+    using AbstractStoreBackend::setProductStatus;
+
+    // Registers every product the store has been asked about
+    void registerAll()
+    {
+        for (const QString &identifier : std::exchange(registered, {})) {
+            ProductStoreData data;
+            data.title = identifier;
+            data.price = "1.00";
+            applyStoreData(_catalog.handle(identifier), data, AbstractProduct::Registered);
+        }
+    }
+
+    // Like the platform backends, holds restored purchases back until processing is enabled
+    void restore(const Transaction &transaction)
+    {
+        if (processingEnabled())
+            emit purchaseRestored(transaction);
+        else
+            heldRestores.append(transaction);
+    }
+
+    QStringList registered;
+    QStringList purchased;
+    QList<Transaction> consumed;
+    int restores = 0;
+    QList<Transaction> heldRestores;
+
+protected:
+    void restorePurchasesImpl() override { ++restores; }
+    void processQueuedTransactions() override
+    {
+        for (const Transaction &transaction : std::exchange(heldRestores, {}))
+            emit purchaseRestored(transaction);
+    }
+    AbstractProduct * createProduct(ProductCatalog::Handle handle) override
+    {
+        Q_UNUSED(handle)
+        return new TestStoreProduct();
+    }
+};
+
+#endif // TESTSTOREBACKEND_H
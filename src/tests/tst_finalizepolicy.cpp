@@ -0,0 +1,109 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "teststorebackend.h"
+
+namespace {
+Transaction coinsTransaction()
+{
+    Transaction transaction;
+    transaction.orderId = "order-1";
+    transaction.productId = "coins";
+    transaction.purchaseToken = "token-1";
+    return transaction;
+}
+} // namespace
+
+class TestFinalizePolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void autoFinalizeConsumes();
+    void failedFinalizeIsRedelivered();
+    void unansweredFinalizeTimesOut();
+
+private:
+    TestStoreBackend * _store = nullptr;
+    AbstractProduct * _coins = nullptr;
+};
+
+void TestFinalizePolicy::init()
+{
+    _store = new TestStoreBackend;
+    _store->setFinalizePolicy(AbstractProduct::AutoFinalize);
+    _store->addProduct("coins", AbstractProduct::Consumable);
+    _store->setConnected(true);
+    _store->registerAll();
+    _coins = _store->product("coins");
+    QVERIFY(_coins);
+    QCOMPARE(_coins->status(), AbstractProduct::Registered);
+}
+
+void TestFinalizePolicy::cleanup()
+{
+    delete _store;
+    _store = nullptr;
+    _coins = nullptr;
+}
+
+void TestFinalizePolicy::autoFinalizeConsumes()
+{
+    QSignalSpy completed(_store, &AbstractStoreBackend::finalizeAllCompleted);
+
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QTRY_COMPARE(_store->consumed.size(), 1);
+
+    emit _store->consumePurchaseSucceeded(_store->consumed.first());
+    QCOMPARE(completed.size(), 1);
+    const auto results = completed.first().first().value<QList<FinalizeResult>>();
+    QCOMPARE(results.size(), 1);
+    QVERIFY(results.first().succeeded);
+}
+
+void TestFinalizePolicy::failedFinalizeIsRedelivered()
+{
+    QSignalSpy purchased(_coins, &AbstractProduct::purchaseSucceeded);
+    QSignalSpy completed(_store, &AbstractStoreBackend::finalizeAllCompleted);
+
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QTRY_COMPARE(_store->consumed.size(), 1);
+    QCOMPARE(purchased.size(), 1);
+
+    // Owned by the policy while it is being finalized
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QCOMPARE(purchased.size(), 1);
+
+    emit _store->consumePurchaseFailed(_store->consumed.first());
+    QCOMPARE(completed.size(), 1);
+    QVERIFY(!completed.first().first().value<QList<FinalizeResult>>().first().succeeded);
+
+    // Released on failure: the next delivery reaches the product and is finalized again
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QCOMPARE(purchased.size(), 2);
+    QTRY_COMPARE(_store->consumed.size(), 2);
+}
+
+void TestFinalizePolicy::unansweredFinalizeTimesOut()
+{
+    _store->setFinalizeTimeout(50);
+    QSignalSpy purchased(_coins, &AbstractProduct::purchaseSucceeded);
+    QSignalSpy failed(_coins, &AbstractProduct::consumePurchaseFailed);
+    QSignalSpy completed(_store, &AbstractStoreBackend::finalizeAllCompleted);
+
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QTRY_COMPARE(_store->consumed.size(), 1);
+
+    // The store never answers
+    QTRY_COMPARE(failed.size(), 1);
+    QCOMPARE(completed.size(), 1);
+
+    emit _store->purchaseSucceeded(coinsTransaction());
+    QCOMPARE(purchased.size(), 2);
+}
+
+QTEST_GUILESS_MAIN(TestFinalizePolicy)
+#include "tst_finalizepolicy.moc"
@@ -0,0 +1,194 @@
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <qt6purchasing/httptransactionverifier.h>
+
+#include <functional>
+
+namespace {
+Transaction transaction(const QString &orderId, const QString &productId, const QString &purchaseToken = {})
+{
+    Transaction transaction;
+    transaction.orderId = orderId;
+    transaction.productId = productId;
+    transaction.purchaseToken = purchaseToken;
+    return transaction;
+}
+
+// Minimal HTTP/1.1 server answering each POST with the JSON results the responder builds
+class VerificationServer : public QObject
+{
+public:
+    using Responder = std::function<QJsonArray(const QJsonArray &transactions)>;
+
+    explicit VerificationServer(Responder responder) : _responder(std::move(responder))
+    {
+        connect(&_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket * socket = _server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { serve(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        _server.listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/verify").arg(_server.serverPort())); }
+    QList<QJsonArray> requests; // the transactions of each request received
+
+private:
+    void serve(QTcpSocket * socket)
+    {
+        QByteArray &buffer = _buffers[socket];
+        buffer += socket->readAll();
+
+        // Several requests may arrive on one kept-alive connection
+        for (;;) {
+            const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0)
+                return;
+
+            qsizetype contentLength = 0;
+            for (const QByteArray &line : buffer.left(headerEnd).split('\n')) {
+                const qsizetype colon = line.indexOf(':');
+                if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length")
+                    contentLength = line.mid(colon + 1).trimmed().toLongLong();
+            }
+            if (buffer.size() < headerEnd + 4 + contentLength)
+                return;
+
+            const QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+            buffer.remove(0, headerEnd + 4 + contentLength);
+
+            const QJsonArray transactions = QJsonDocument::fromJson(body).object().value("transactions").toArray();
+            requests.append(transactions);
+
+            QJsonObject answer;
+            answer["results"] = _responder(transactions);
+            const QByteArray json = QJsonDocument(answer).toJson(QJsonDocument::Compact);
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+                          + QByteArray::number(json.size()) + "\r\n\r\n" + json);
+        }
+    }
+
+    QTcpServer _server;
+    QHash<QTcpSocket *, QByteArray> _buffers;
+    Responder _responder;
+};
+
+// Valid unless the product id starts with "bad"
+QJsonArray judgeByProduct(const QJsonArray &transactions)
+{
+    QJsonArray results;
+    for (const QJsonValue &value : transactions) {
+        const QJsonObject entry = value.toObject();
+        QJsonObject result;
+        result["id"] = entry["id"];
+        result["valid"] = !entry["productId"].toString().startsWith("bad");
+        results.append(result);
+    }
+    return results;
+}
+} // namespace
+
+class TestHttpTransactionVerifier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void burstIsSentAsOneBatch();
+    void transactionsWithoutOrderIdGetTheirOwnVerdicts();
+    void missingResultIsAnError();
+
+private:
+    void startServer(VerificationServer::Responder responder);
+
+    VerificationServer * _server = nullptr;
+    HttpTransactionVerifier * _verifier = nullptr;
+    QHash<QString, TransactionVerifier::Verdict> _verdicts; // by Transaction::key()
+};
+
+void TestHttpTransactionVerifier::init()
+{
+    _verifier = new HttpTransactionVerifier;
+    _verifier->setBatchDelay(20);
+    connect(_verifier, &TransactionVerifier::verified, this,
+            [this](const Transaction &transaction, TransactionVerifier::Verdict verdict) {
+                QVERIFY(!_verdicts.contains(transaction.key()));
+                _verdicts.insert(transaction.key(), verdict);
+            });
+}
+
+void TestHttpTransactionVerifier::cleanup()
+{
+    delete _verifier;
+    _verifier = nullptr;
+    delete _server;
+    _server = nullptr;
+    _verdicts.clear();
+}
+
+void TestHttpTransactionVerifier::startServer(VerificationServer::Responder responder)
+{
+    _server = new VerificationServer(std::move(responder));
+    _verifier->setEndpoint(_server->url());
+}
+
+void TestHttpTransactionVerifier::burstIsSentAsOneBatch()
+{
+    startServer(judgeByProduct);
+
+    _verifier->verify(transaction("order-1", "coins"));
+    _verifier->verify(transaction("order-2", "bad-coins"));
+    _verifier->verify(transaction("order-3", "gems"));
+
+    QTRY_COMPARE(_verdicts.size(), 3);
+    QCOMPARE(_server->requests.size(), 1);
+    QCOMPARE(_server->requests.first().size(), 3);
+    QCOMPARE(_verdicts.value("order-1"), TransactionVerifier::Valid);
+    QCOMPARE(_verdicts.value("order-2"), TransactionVerifier::Invalid);
+    QCOMPARE(_verdicts.value("order-3"), TransactionVerifier::Valid);
+}
+
+void TestHttpTransactionVerifier::transactionsWithoutOrderIdGetTheirOwnVerdicts()
+{
+    startServer(judgeByProduct);
+
+    // Test purchases: identified by purchase token, or by product id when there is neither
+    _verifier->verify(transaction({}, "coins", "token-1"));
+    _verifier->verify(transaction({}, "bad-coins", "token-2"));
+    _verifier->verify(transaction({}, "bad-gems"));
+
+    QTRY_COMPARE(_verdicts.size(), 3);
+    QCOMPARE(_server->requests.size(), 1);
+    QCOMPARE(_server->requests.first().at(0).toObject().value("id").toString(), QString("token-1"));
+    QCOMPARE(_verdicts.value("token-1"), TransactionVerifier::Valid);
+    QCOMPARE(_verdicts.value("token-2"), TransactionVerifier::Invalid);
+    QCOMPARE(_verdicts.value("bad-gems"), TransactionVerifier::Invalid);
+}
+
+void TestHttpTransactionVerifier::missingResultIsAnError()
+{
+    startServer([](const QJsonArray &transactions) {
+        QJsonArray results = judgeByProduct(transactions);
+        results.removeLast();
+        return results;
+    });
+
+    _verifier->verify(transaction("order-1", "coins"));
+    _verifier->verify(transaction("order-2", "gems"));
+
+    QTRY_COMPARE(_verdicts.size(), 2);
+    QCOMPARE(_verdicts.value("order-1"), TransactionVerifier::Valid);
+    QCOMPARE(_verdicts.value("order-2"), TransactionVerifier::Error);
+}
+
+QTEST_GUILESS_MAIN(TestHttpTransactionVerifier)
+#include "tst_httptransactionverifier.moc"
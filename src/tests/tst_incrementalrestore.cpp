@@ -0,0 +1,91 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "teststorebackend.h"
+
+namespace {
+Transaction premiumTransaction()
+{
+    Transaction transaction;
+    transaction.orderId = "order-1";
+    transaction.productId = "premium";
+    return transaction;
+}
+} // namespace
+
+class TestIncrementalRestore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void missingProductIsRevoked();
+    void restoreWaitsForQueuedPurchases();
+
+private:
+    TestStoreBackend * _store = nullptr;
+    AbstractProduct * _premium = nullptr;
+};
+
+void TestIncrementalRestore::init()
+{
+    _store = new TestStoreBackend;
+    _store->setIncrementalRestore(true);
+    _store->addProduct("premium", AbstractProduct::Unlockable);
+    _store->setOwnedProducts({"premium"});
+    _store->setConnected(true);
+    _store->registerAll();
+    _premium = _store->product("premium");
+    QVERIFY(_premium);
+}
+
+void TestIncrementalRestore::cleanup()
+{
+    delete _store;
+    _store = nullptr;
+    _premium = nullptr;
+}
+
+void TestIncrementalRestore::missingProductIsRevoked()
+{
+    _store->enableProcessing();
+    QSignalSpy revoked(_store, &AbstractStoreBackend::restoredPurchaseRevoked);
+    QSignalSpy productRevoked(_premium, &AbstractProduct::purchaseRevoked);
+
+    _store->restorePurchases();
+    QCOMPARE(_store->restores, 1);
+    emit _store->restorePurchasesSucceeded(0);
+
+    QVERIFY(!_store->isRestoringPurchases());
+    QCOMPARE(revoked.size(), 1);
+    QCOMPARE(productRevoked.size(), 1);
+    QVERIFY(_store->ownedProducts().isEmpty());
+}
+
+void TestIncrementalRestore::restoreWaitsForQueuedPurchases()
+{
+    QSignalSpy revoked(_store, &AbstractStoreBackend::restoredPurchaseRevoked);
+    QSignalSpy added(_store, &AbstractStoreBackend::restoredPurchaseAdded);
+    QSignalSpy productRevoked(_premium, &AbstractProduct::purchaseRevoked);
+
+    // As on Android: the restore completes while its purchases are held until processing is enabled
+    _store->restorePurchases();
+    QCOMPARE(_store->restores, 1);
+    _store->restore(premiumTransaction());
+    emit _store->restorePurchasesSucceeded(1);
+
+    QVERIFY(_store->isRestoringPurchases());
+    QCOMPARE(revoked.size(), 0);
+
+    _store->enableProcessing();
+    QTRY_VERIFY(!_store->isRestoringPurchases());
+    QCOMPARE(revoked.size(), 0);
+    QCOMPARE(productRevoked.size(), 0);
+    QCOMPARE(added.size(), 0);
+    QCOMPARE(_store->ownedProducts(), QStringList{"premium"});
+}
+
+QTEST_GUILESS_MAIN(TestIncrementalRestore)
+#include "tst_incrementalrestore.moc"
@@ -0,0 +1,137 @@
+#include <QDeadlineTimer>
+#include <QTest>
+
+#include <qt6purchasing/storeeventqueue.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int ProducerCount = 8;
+constexpr int ItemsPerProducer = 100000;
+
+struct Item
+{
+    int producer = -1;
+    int sequence = -1;
+};
+} // namespace
+
+class TestMpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void singleThread();
+    void producersKeepTheirOrder();
+    void eventQueueDeliversEveryEvent();
+};
+
+void TestMpscQueue::singleThread()
+{
+    MpscQueue<int> queue;
+    int value = 0;
+    QVERIFY(!queue.pop(value));
+
+    for (int i = 0; i < 3; ++i)
+        queue.push(i);
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(queue.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!queue.pop(value));
+
+    // Emptied and refilled through the stub node
+    queue.push(42);
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 42);
+}
+
+void TestMpscQueue::producersKeepTheirOrder()
+{
+    MpscQueue<Item> queue;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < ProducerCount; ++producer) {
+        producers.emplace_back([&queue, &go, producer]() {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (int sequence = 0; sequence < ItemsPerProducer; ++sequence)
+                queue.push({producer, sequence});
+        });
+    }
+
+    // Consumed while the producers are still pushing
+    go.store(true, std::memory_order_release);
+    std::vector<int> next(ProducerCount, 0);
+    int received = 0;
+    bool ordered = true;
+    Item item;
+    while (received < ProducerCount * ItemsPerProducer) {
+        if (!queue.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && item.sequence == next[item.producer];
+        next[item.producer] = item.sequence + 1;
+        ++received;
+    }
+
+    for (std::thread &producer : producers)
+        producer.join();
+
+    QVERIFY(ordered);
+    QVERIFY(!queue.pop(item));
+    for (int producer = 0; producer < ProducerCount; ++producer)
+        QCOMPARE(next[producer], ItemsPerProducer);
+}
+
+void TestMpscQueue::eventQueueDeliversEveryEvent()
+{
+    constexpr int EventsPerProducer = 20000;
+    std::vector<int> next(ProducerCount, 0);
+    int received = 0;
+    bool ordered = true;
+
+    QObject receiver;
+    StoreEventQueue queue(&receiver, [&](const StoreEvent &event) {
+        ordered = ordered && event.code == next[event.type] && event.text == QString::number(event.code);
+        next[event.type] = event.code + 1;
+        ++received;
+    });
+    queue.setDecoder([](StoreEvent &event) { event.text = QString::number(event.code); });
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < ProducerCount; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int sequence = 0; sequence < EventsPerProducer; ++sequence) {
+                StoreEvent event;
+                event.type = producer;
+                event.code = sequence;
+                queue.post(std::move(event));
+            }
+        });
+    }
+
+    // Decoding moves between the worker and this thread while events arrive
+    bool background = false;
+    QDeadlineTimer deadline(30000);
+    while (received < ProducerCount * EventsPerProducer && !deadline.hasExpired()) {
+        background = !background;
+        queue.setDecodeInBackground(background);
+        QTest::qWait(1);
+    }
+
+    for (std::thread &producer : producers)
+        producer.join();
+
+    QCOMPARE(received, ProducerCount * EventsPerProducer);
+    QVERIFY(ordered);
+    for (int producer = 0; producer < ProducerCount; ++producer)
+        QCOMPARE(next[producer], EventsPerProducer);
+}
+
+QTEST_GUILESS_MAIN(TestMpscQueue)
+#include "tst_mpscqueue.moc"
@@ -0,0 +1,76 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "teststorebackend.h"
+
+class TestStartup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void readyAfterRegistration();
+    void notReadyWhileDisconnected();
+    void registrationLostWithConnectionIsRepeated();
+
+private:
+    TestStoreBackend * _store = nullptr;
+};
+
+void TestStartup::init()
+{
+    _store = new TestStoreBackend;
+    _store->addProduct("coins", AbstractProduct::Consumable);
+    _store->setConnected(true);
+}
+
+void TestStartup::cleanup()
+{
+    delete _store;
+    _store = nullptr;
+}
+
+void TestStartup::readyAfterRegistration()
+{
+    QSignalSpy ready(_store, &AbstractStoreBackend::readyChanged);
+    QCOMPARE(_store->registered, QStringList{"coins"});
+    QVERIFY(!_store->isReady());
+
+    _store->registerAll();
+
+    QTRY_VERIFY(_store->isReady());
+    QCOMPARE(ready.count(), 1);
+}
+
+void TestStartup::notReadyWhileDisconnected()
+{
+    _store->registerAll();
+    QTRY_VERIFY(_store->isReady());
+    QSignalSpy ready(_store, &AbstractStoreBackend::readyChanged);
+
+    _store->setConnected(false);
+    QVERIFY(!_store->isReady());
+    QCOMPARE(ready.count(), 1);
+
+    // Already registered, so ready again once the startup steps have run
+    _store->setConnected(true);
+    QTRY_VERIFY(_store->isReady());
+    QCOMPARE(ready.count(), 2);
+}
+
+void TestStartup::registrationLostWithConnectionIsRepeated()
+{
+    _store->registered.clear();
+    _store->setConnected(false);
+    QCOMPARE(_store->productForHandle(0)->status(), AbstractProduct::Uninitialized);
+
+    _store->setConnected(true);
+    QCOMPARE(_store->registered, QStringList{"coins"});
+    _store->registerAll();
+    QTRY_VERIFY(_store->isReady());
+}
+
+QTEST_GUILESS_MAIN(TestStartup)
+#include "tst_startup.moc"
@@ -0,0 +1,326 @@
+#include <qt6purchasing/transactionhistory.h>
+#include <qt6purchasing/storelogging.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QtEndian>
+
+#include <limits>
+
+namespace {
+constexpr quint32 IndexMagic = 0x58485051;    // "QPHX"
+constexpr quint32 DataMagic = 0x44485051;     // "QPHD"
+constexpr quint32 ProductsMagic = 0x50485051; // "QPHP"
+constexpr quint32 FormatVersion = 1;
+constexpr int StreamVersion = QDataStream::Qt_6_0;
+} // namespace
+
+bool TransactionHistory::open(const QString &directory)
+{
+    close();
+
+    if (!QDir().mkpath(directory)) {
+        qCWarning(lcStore) << "Failed to create transaction history directory" << directory;
+        return false;
+    }
+
+    const QDir dir(directory);
+    if (!openFile(_index, dir.filePath("history.idx"), IndexMagic)
+        || !openFile(_data, dir.filePath("history.dat"), DataMagic)
+        || !openFile(_products, dir.filePath("products.dat"), ProductsMagic) || !loadProducts()) {
+        close();
+        return false;
+    }
+
+    _directory = directory;
+    recover();
+    qCDebug(lcStore) << "Opened transaction history with" << _entryCount << "record(s)";
+    return true;
+}
+
+void TransactionHistory::close()
+{
+    unmapIndex();
+    _index.close();
+    _data.close();
+    _products.close();
+
+    _directory.clear();
+    _entryCount = 0;
+    _lastTimestamp = 0;
+    _productIds.clear();
+    _productIndexes.clear();
+    _lastEntries.clear();
+}
+
+bool TransactionHistory::openFile(QFile &file, const QString &name, quint32 magic)
+{
+    file.setFileName(name);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qCWarning(lcStore) << "Failed to open transaction history file" << name << file.errorString();
+        return false;
+    }
+
+    uchar header[HeaderSize];
+    if (file.size() < HeaderSize) {
+        qToLittleEndian(magic, header);
+        qToLittleEndian(FormatVersion, header + 4);
+        file.resize(0);
+        return file.write(reinterpret_cast<const char *>(header), HeaderSize) == HeaderSize && file.flush();
+    }
+
+    if (file.read(reinterpret_cast<char *>(header), HeaderSize) != HeaderSize
+        || qFromLittleEndian<quint32>(header) != magic || qFromLittleEndian<quint32>(header + 4) != FormatVersion) {
+        qCWarning(lcStore) << "Unsupported transaction history file" << name;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool TransactionHistory::loadProducts()
+{
+    _products.seek(HeaderSize);
+    QDataStream stream(&_products);
+    stream.setVersion(StreamVersion);
+
+    // A product written just before a crash may be truncated; it is re-added when next used
+    qint64 validSize = HeaderSize;
+    while (!stream.atEnd()) {
+        QString productId;
+        stream >> productId;
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        _productIndexes.insert(productId, static_cast<quint32>(_productIds.size()));
+        _productIds.append(productId);
+        validSize = _products.pos();
+    }
+
+    _lastEntries = QList<quint32>(_productIds.size(), NoEntry);
+    return _products.resize(validSize) && _products.seek(validSize);
+}
+
+void TransactionHistory::recover()
+{
+    // Drop a partially written index entry, then any entry whose record did not reach the disk
+    _entryCount = (_index.size() - HeaderSize) / EntrySize;
+    // Nothing can be read back without the mapping: treat the history as empty
+    if (!mapIndex()) {
+        _entryCount = 0;
+        return;
+    }
+    while (_entryCount > 0) {
+        const IndexEntry last = entry(_entryCount - 1);
+        if (last.offset < _data.size() && last.product < static_cast<quint32>(_productIds.size()))
+            break;
+        --_entryCount;
+    }
+    unmapIndex();
+    _index.resize(HeaderSize + _entryCount * EntrySize);
+
+    if (_entryCount == 0)
+        return;
+
+    // Find each product's newest entry, stopping as soon as all products are accounted for
+    if (!mapIndex()) {
+        _entryCount = 0;
+        return;
+    }
+    _lastTimestamp = entry(_entryCount - 1).timestamp;
+    qsizetype remaining = _productIds.size();
+    for (qsizetype number = _entryCount - 1; number >= 0 && remaining > 0; --number) {
+        const quint32 product = entry(number).product;
+        if (_lastEntries.at(product) == NoEntry) {
+            _lastEntries[product] = static_cast<quint32>(number);
+            --remaining;
+        }
+    }
+}
+
+quint32 TransactionHistory::productIndex(const QString &productId)
+{
+    auto it = _productIndexes.constFind(productId);
+    if (it != _productIndexes.constEnd())
+        return *it;
+
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setVersion(StreamVersion);
+    stream << productId;
+
+    _products.seek(_products.size());
+    if (_products.write(bytes) != bytes.size() || !_products.flush())
+        return NoEntry;
+
+    const quint32 index = static_cast<quint32>(_productIds.size());
+    _productIds.append(productId);
+    _productIndexes.insert(productId, index);
+    _lastEntries.append(NoEntry);
+    return index;
+}
+
+bool TransactionHistory::append(TransactionRecord record)
+{
+    if (!isOpen())
+        return false;
+
+    // The index is kept sorted by time, so a clock that moved backwards must not reorder it
+    if (record.timestampMs <= 0)
+        record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.timestampMs = qMax(record.timestampMs, _lastTimestamp);
+
+    const quint32 product = productIndex(record.productId);
+    if (product == NoEntry) {
+        qCWarning(lcStore) << "Failed to record product in transaction history:" << record.productId;
+        return false;
+    }
+
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setVersion(StreamVersion);
+    stream << quint8(record.outcome) << record.orderId << qint32(record.error) << record.message;
+
+    // Data before index: an index entry never points at a record that is not on disk
+    const qint64 offset = _data.size();
+    _data.seek(offset);
+    if (_data.write(bytes) != bytes.size() || !_data.flush()) {
+        qCWarning(lcStore) << "Failed to write transaction history record:" << _data.errorString();
+        return false;
+    }
+
+    uchar raw[EntrySize];
+    qToLittleEndian(record.timestampMs, raw);
+    qToLittleEndian(offset, raw + 8);
+    qToLittleEndian(product, raw + 16);
+    qToLittleEndian(_lastEntries.at(product), raw + 20);
+
+    unmapIndex();
+    _index.seek(HeaderSize + _entryCount * EntrySize);
+    if (_index.write(reinterpret_cast<const char *>(raw), EntrySize) != EntrySize || !_index.flush()) {
+        qCWarning(lcStore) << "Failed to write transaction history index:" << _index.errorString();
+        return false;
+    }
+
+    _lastEntries[product] = static_cast<quint32>(_entryCount);
+    _lastTimestamp = record.timestampMs;
+    ++_entryCount;
+    return true;
+}
+
+QList<TransactionRecord> TransactionHistory::query(
+    const QString &productId, qint64 from, qint64 to, qsizetype offset, qsizetype limit
+)
+{
+    QList<TransactionRecord> result;
+    if (!isOpen() || _entryCount == 0 || limit <= 0 || !mapIndex())
+        return result;
+
+    auto collect = [&](const IndexEntry &found) {
+        TransactionRecord record;
+        if (readRecord(found, record))
+            result.append(record);
+    };
+
+    if (productId.isEmpty()) {
+        // Entries are sorted by time: the page is a contiguous slice ending before 'to'
+        const qsizetype first = lowerBound(from);
+        const qsizetype end = to < std::numeric_limits<qint64>::max() ? lowerBound(to + 1) : _entryCount;
+        for (qsizetype number = end - 1 - offset; number >= first && result.size() < limit; --number)
+            collect(entry(number));
+        return result;
+    }
+
+    const quint32 product = _productIndexes.value(productId, NoEntry);
+    if (product == NoEntry)
+        return result;
+
+    // Walk the product's chain from its newest entry
+    for (quint32 number = _lastEntries.at(product); number != NoEntry && result.size() < limit;) {
+        const IndexEntry current = entry(number);
+        if (current.timestamp < from)
+            break;
+        if (current.timestamp <= to) {
+            if (offset > 0)
+                --offset;
+            else
+                collect(current);
+        }
+        number = current.previous;
+    }
+    return result;
+}
+
+bool TransactionHistory::mapIndex()
+{
+    if (_mappedIndex && _mappedCount == _entryCount)
+        return true;
+
+    unmapIndex();
+    if (_entryCount == 0)
+        return true;
+
+    _mappedIndex = _index.map(HeaderSize, _entryCount * EntrySize);
+    if (!_mappedIndex) {
+        qCWarning(lcStore) << "Failed to map transaction history index:" << _index.errorString();
+        return false;
+    }
+    _mappedCount = _entryCount;
+    return true;
+}
+
+void TransactionHistory::unmapIndex()
+{
+    if (_mappedIndex)
+        _index.unmap(_mappedIndex);
+    _mappedIndex = nullptr;
+    _mappedCount = 0;
+}
+
+TransactionHistory::IndexEntry TransactionHistory::entry(qsizetype number) const
+{
+    const uchar * raw = _mappedIndex + number * EntrySize;
+    return {
+        qFromLittleEndian<qint64>(raw),
+        qFromLittleEndian<qint64>(raw + 8),
+        qFromLittleEndian<quint32>(raw + 16),
+        qFromLittleEndian<quint32>(raw + 20)
+    };
+}
+
+qsizetype TransactionHistory::lowerBound(qint64 timestamp) const
+{
+    qsizetype low = 0;
+    qsizetype high = _entryCount;
+    while (low < high) {
+        const qsizetype middle = low + (high - low) / 2;
+        if (entry(middle).timestamp < timestamp)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+bool TransactionHistory::readRecord(const IndexEntry &entry, TransactionRecord &record)
+{
+    if (!_data.seek(entry.offset))
+        return false;
+
+    QDataStream stream(&_data);
+    stream.setVersion(StreamVersion);
+
+    quint8 outcome = 0;
+    qint32 error = 0;
+    stream >> outcome >> record.orderId >> error >> record.message;
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(lcStore) << "Corrupt transaction history record at offset" << entry.offset;
+        return false;
+    }
+
+    record.timestampMs = entry.timestamp;
+    record.productId = _productIds.at(entry.product);
+    record.outcome = static_cast<TransactionRecord::Outcome>(outcome);
+    record.error = error;
+    return true;
+}
@@ -15,7 +15,7 @@ MicrosoftStoreBackend * MicrosoftStoreBackend::s_currentInstance = nullptr;
 
 MicrosoftStoreBackend::MicrosoftStoreBackend(QObject * parent) : AbstractStoreBackend(parent), _hwnd(nullptr)
 {
-    qDebug() << "Creating Microsoft Store backend";
+    qCDebug(lcStore) << "Creating Microsoft Store backend";
 
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
     s_currentInstance = this;
@@ -23,6 +23,12 @@ MicrosoftStoreBackend::MicrosoftStoreBackend(QObject * parent) : AbstractStoreBa
     // Cache window handle early
     initializeWindowHandle();
 
+    // The Store consumes by quantity, so consumables finalized close together share one report
+    setConsumptionWindow(100);
+
+    // Restore alongside product registration rather than after the product query
+    setRestoreOnConnect(true);
+
     startConnection();
 }
 
@@ -31,7 +37,7 @@ MicrosoftStoreBackend::~MicrosoftStoreBackend()
     // Safely end all in-flight worker threads before the base ~QObject.
     const auto workerThreads = _workerThreads;
     if (!workerThreads.isEmpty())
-        qDebug() << "Joining" << workerThreads.size() << "in-flight worker thread(s) before teardown";
+        qCDebug(lcStore) << "Joining" << workerThreads.size() << "in-flight worker thread(s) before teardown";
     for (QThread * thread : workerThreads) {
         thread->quit();
         thread->wait();
@@ -40,45 +46,49 @@ MicrosoftStoreBackend::~MicrosoftStoreBackend()
     if (s_currentInstance == this)
         s_currentInstance = nullptr;
 
-    qDebug() << "Destroying Microsoft Store backend";
+    qCDebug(lcStore) << "Destroying Microsoft Store backend";
 }
 
 void MicrosoftStoreBackend::startConnection()
 {
-    qDebug() << "Initializing Microsoft Store connection";
+    qCDebug(lcStore) << "Initializing Microsoft Store connection";
 
     // Simple connection check - we'll initialize StoreContext in workers
     setConnected(true);
     setCanMakePurchases(canMakePurchases());
-    qDebug() << "Microsoft Store connection established";
+    qCDebug(lcStore) << "Microsoft Store connection established";
 
-    // Query all products on startup
+    // Diagnostic listing of the Store's products; registration and restore run independently
     queryAllProducts();
-
-    // Note: restorePurchases() will be called after products are queried
 }
 
-void MicrosoftStoreBackend::registerProduct(AbstractProduct * product)
+void MicrosoftStoreBackend::registerProduct(const QString &identifier)
 {
+    const ProductCatalog::Handle handle = _catalog.handle(identifier);
+    if (handle < 0) {
+        qCWarning(lcStore) << "Cannot register product - not in catalog:" << identifier;
+        return;
+    }
+
     if (!isConnected()) {
-        qWarning() << "Cannot register product - store not connected";
-        product->setStatus(AbstractProduct::Unknown);
+        qCWarning(lcStore) << "Cannot register product - store not connected";
+        setProductStatus(handle, AbstractProduct::Unknown);
         return;
     }
 
     if (!_hwnd) {
-        qWarning() << "No window handle available for product registration";
-        product->setStatus(AbstractProduct::Unknown);
+        qCWarning(lcStore) << "No window handle available for product registration";
+        setProductStatus(handle, AbstractProduct::Unknown);
         return;
     }
 
     // Use microsoftStoreId if available, otherwise use identifier
-    QString productId = product->identifier();
+    QString productId = identifier;
 #ifdef Q_OS_WIN
-    QString microsoftStoreId = product->microsoftStoreId();
+    QString microsoftStoreId = _catalog.microsoftStoreId(handle);
     if (!microsoftStoreId.isEmpty()) {
         productId = microsoftStoreId;
-        qDebug() << "Using Microsoft Store ID:" << productId << "for product:" << product->identifier();
+        qCDebug(lcStore) << "Using Microsoft Store ID:" << productId << "for product:" << identifier;
     }
 #endif
 
@@ -91,8 +101,8 @@ void MicrosoftStoreBackend::registerProduct(AbstractProduct * product)
         worker,
         &StoreProductQueryWorker::querySucceeded,
         this,
-        [this, product](const QVariantMap &productData) {
-            this->onProductQuerySucceeded(product, productData);
+        [this, identifier](const QVariantMap &productData) {
+            this->onProductQuerySucceeded(identifier, productData);
         },
         Qt::QueuedConnection
     );
@@ -100,8 +110,8 @@ void MicrosoftStoreBackend::registerProduct(AbstractProduct * product)
         worker,
         &StoreProductQueryWorker::queryFailed,
         this,
-        [this, product](uint32_t hresult, const QString &message) {
-            this->onProductQueryFailed(product, hresult, message);
+        [this, identifier](uint32_t hresult, const QString &message) {
+            this->onProductQueryFailed(identifier, hresult, message);
         },
         Qt::QueuedConnection
     );
@@ -116,7 +126,7 @@ void MicrosoftStoreBackend::registerProduct(AbstractProduct * product)
 void MicrosoftStoreBackend::purchaseProduct(AbstractProduct * product)
 {
     if (!isConnected()) {
-        qWarning() << "Cannot purchase - store not connected";
+        qCWarning(lcStore) << "Cannot purchase - store not connected";
         // Use a generic service unavailable error code
         constexpr uint32_t SERVICE_UNAVAILABLE = 0x80070005; // E_ACCESSDENIED
         PurchaseError error = PurchaseError::ServiceUnavailable;
@@ -127,7 +137,7 @@ void MicrosoftStoreBackend::purchaseProduct(AbstractProduct * product)
     }
 
     if (!_hwnd) {
-        qWarning() << "No window handle available for purchase";
+        qCWarning(lcStore) << "No window handle available for purchase";
         // Use a generic unknown error code
         constexpr uint32_t UNKNOWN_ERROR = 0x80004005; // E_FAIL
         PurchaseError error = PurchaseError::UnknownError;
@@ -170,62 +180,124 @@ void MicrosoftStoreBackend::purchaseProduct(AbstractProduct * product)
 
 void MicrosoftStoreBackend::consumePurchase(Transaction transaction)
 {
-    qDebug() << "Consume transaction called for:" << transaction.orderId << "Product:" << transaction.productId;
+    qCDebug(lcStore) << "Consume transaction called for:" << transaction.orderId << "Product:" << transaction.productId;
+
+    QString storeId;
+    if (prepareFulfillment(transaction, storeId))
+        fulfillConsumables({{transaction}}, {storeId});
+}
+
+bool MicrosoftStoreBackend::consumeQuantity(const QList<Transaction> &transactions)
+{
+    qCDebug(lcStore) << "Consuming" << transactions.size() << "unit(s) of" << transactions.first().productId;
+
+    // All transactions are for the same product, so they share a Store ID
+    QList<Transaction> consumables;
+    QString storeId;
+    for (const Transaction &transaction : transactions) {
+        if (prepareFulfillment(transaction, storeId))
+            consumables.append(transaction);
+    }
+
+    if (!consumables.isEmpty())
+        fulfillConsumables({consumables}, {storeId});
+    return true;
+}
 
+void MicrosoftStoreBackend::finalizeBatch(const QList<Transaction> &transactions)
+{
+    qCDebug(lcStore) << "Finalizing batch of" << transactions.size() << "transaction(s)";
+
+    // One report per Store ID, for the quantity of that product in the batch
+    QList<QList<Transaction>> groups;
+    QStringList storeIds;
+    for (const Transaction &transaction : transactions) {
+        QString storeId;
+        if (!prepareFulfillment(transaction, storeId))
+            continue;
+
+        const qsizetype group = storeIds.indexOf(storeId);
+        if (group < 0) {
+            groups.append({transaction});
+            storeIds.append(storeId);
+        } else {
+            groups[group].append(transaction);
+        }
+    }
+
+    if (groups.isEmpty())
+        return;
+
+    // The batch shares the consume rate limit and finalizeTimeout with single finalizations
+    QList<Transaction> fulfilling;
+    for (const QList<Transaction> &group : std::as_const(groups))
+        fulfilling.append(group);
+    submitFinalization(fulfilling, [this, groups, storeIds]() { fulfillConsumables(groups, storeIds); });
+}
+
+bool MicrosoftStoreBackend::prepareFulfillment(const Transaction &transaction, QString &storeId)
+{
     // Look up the product to check its type
-    AbstractProduct * product = _registeredProducts.value(transaction.productId, nullptr);
+    const ProductCatalog::Handle handle = _catalog.handle(transaction.productId);
 
-    if (!product) {
-        qWarning() << "Cannot find product for transaction:" << transaction.productId;
+    if (handle < 0 || _catalog.status(handle) != AbstractProduct::Registered) {
+        qCWarning(lcStore) << "Cannot find product for transaction:" << transaction.productId;
         emit consumePurchaseFailed(transaction);
-        return;
+        return false;
     }
 
     // Only consumables need fulfillment
-    if (product->productType() != AbstractProduct::Consumable) {
-        qDebug() << "Product is not consumable (type:" << product->productType() << "), no fulfillment needed";
+    const AbstractProduct::ProductType productType = _catalog.productType(handle);
+    if (productType != AbstractProduct::Consumable) {
+        qCDebug(lcStore) << "Product is not consumable (type:" << productType << "), no fulfillment needed";
         emit consumePurchaseSucceeded(transaction);
-        return;
+        return false;
     }
 
-    // For consumables, we need to report fulfillment to Microsoft Store
-    qDebug() << "Product is consumable, reporting fulfillment to Microsoft Store";
-    qDebug() << "Note: Fulfillment may fail in debug mode - requires proper Store packaging";
-
     if (!_hwnd) {
-        qWarning() << "No window handle available for consumable fulfillment";
+        qCWarning(lcStore) << "No window handle available for consumable fulfillment";
         emit consumePurchaseFailed(transaction);
-        return;
+        return false;
     }
 
     // Get the Microsoft Store ID
-    QString storeId = transaction.productId;
+    storeId = transaction.productId;
 #ifdef Q_OS_WIN
-    QString microsoftStoreId = product->microsoftStoreId();
+    QString microsoftStoreId = _catalog.microsoftStoreId(handle);
     if (!microsoftStoreId.isEmpty()) {
         storeId = microsoftStoreId;
-        qDebug() << "Using Microsoft Store ID for fulfillment:" << storeId;
+        qCDebug(lcStore) << "Using Microsoft Store ID for fulfillment:" << storeId;
     }
 #endif
+    return true;
+}
 
-    // Create fulfillment worker
-    auto * worker = new StoreConsumableFulfillmentWorker(storeId, 1, _hwnd); // quantity = 1
+void MicrosoftStoreBackend::fulfillConsumables(const QList<QList<Transaction>> &groups, const QStringList &storeIds)
+{
+    // For consumables, we need to report fulfillment to Microsoft Store
+    QList<uint32_t> quantities;
+    for (const QList<Transaction> &group : groups)
+        quantities.append(static_cast<uint32_t>(group.size()));
+    qCDebug(lcStore) << "Reporting fulfillment of" << groups.size() << "consumable(s) to Microsoft Store, quantities:"
+                     << quantities;
+    qCDebug(lcStore) << "Note: Fulfillment may fail in debug mode - requires proper Store packaging";
+
+    // One worker and StoreContext for the whole batch
+    auto * worker = new StoreConsumableFulfillmentWorker(storeIds, quantities, _hwnd);
     auto * thread = new QThread(this);
 
     worker->moveToThread(thread);
     connect(thread, &QThread::started, worker, &StoreConsumableFulfillmentWorker::performFulfillment);
 
-    // Capture transaction data by value for logging
-    QString orderId = transaction.orderId;
-    QString productId = transaction.productId;
     connect(
         worker,
         &StoreConsumableFulfillmentWorker::fulfillmentSucceeded,
         this,
-        [this, transaction, orderId, productId]() {
-            qDebug() << "Consumable fulfillment completed successfully for product:" << productId
-                     << "order:" << orderId;
-            emit consumePurchaseSucceeded(transaction);
+        [this, groups](int index) {
+            const QList<Transaction> &group = groups.at(index);
+            qCDebug(lcStore) << "Consumable fulfillment completed successfully for product:" << group.first().productId
+                             << "quantity:" << group.size();
+            finishConsumeQuantity(group, true);
         },
         Qt::QueuedConnection
     );
@@ -233,18 +305,20 @@ void MicrosoftStoreBackend::consumePurchase(Transaction transaction)
         worker,
         &StoreConsumableFulfillmentWorker::fulfillmentFailed,
         this,
-        [this, transaction, orderId, productId](uint32_t errorCode, const QString &message) {
-            qWarning() << "Consumable fulfillment failed for product:" << productId << "order:" << orderId
-                       << "Error code:" << Qt::hex << Qt::showbase << errorCode << "Message:" << message;
+        [this, groups](int index, uint32_t errorCode, const QString &message) {
+            const QList<Transaction> &group = groups.at(index);
+            qCWarning(lcStore) << "Consumable fulfillment failed for product:" << group.first().productId
+                               << "quantity:" << group.size() << "Error code:" << Qt::hex << Qt::showbase << errorCode
+                               << "Message:" << message;
 
             // Check if this is a debug mode limitation
             if (message.contains("Server error") || errorCode == 0x803f6107) {
-                qWarning() << "Note: Fulfillment errors are common in debug mode. "
-                           << "This app needs to be properly packaged and signed for the Microsoft Store "
-                           << "for consumable fulfillment to work correctly.";
+                qCWarning(lcStore) << "Note: Fulfillment errors are common in debug mode. "
+                                   << "This app needs to be properly packaged and signed for the Microsoft Store "
+                                   << "for consumable fulfillment to work correctly.";
             }
 
-            emit consumePurchaseFailed(transaction);
+            finishConsumeQuantity(group, false);
         },
         Qt::QueuedConnection
     );
@@ -264,29 +338,18 @@ bool MicrosoftStoreBackend::canMakePurchases() const
     return isConnected();
 }
 
-void MicrosoftStoreBackend::enableProcessing()
-{
-    if (processingEnabled())
-        return;
-
-    AbstractStoreBackend::enableProcessing();
-
-    qDebug() << "Windows: Processing enabled - processing queued transactions";
-    processQueuedTransactions();
-}
-
 void MicrosoftStoreBackend::restorePurchasesImpl()
 {
-    qDebug() << "restorePurchasesImpl() called, products count:" << products().size();
+    qCDebug(lcStore) << "restorePurchasesImpl() called, products count:" << _catalog.size();
 
     if (!isConnected()) {
-        qWarning() << "Cannot restore purchases - store not connected";
+        qCWarning(lcStore) << "Cannot restore purchases - store not connected";
         emit restorePurchasesFailed(static_cast<int>(PurchaseError::ServiceUnavailable), 0, "Store not connected");
         return;
     }
 
     if (!_hwnd) {
-        qWarning() << "No window handle available for restore";
+        qCWarning(lcStore) << "No window handle available for restore";
         emit restorePurchasesFailed(static_cast<int>(PurchaseError::DeveloperError), 0, "No window handle available");
         return;
     }
@@ -314,64 +377,78 @@ void MicrosoftStoreBackend::restorePurchasesImpl()
     thread->start();
 }
 
-void MicrosoftStoreBackend::onProductQuerySucceeded(AbstractProduct * product, const QVariantMap &productData)
+AbstractProduct * MicrosoftStoreBackend::createProduct(ProductCatalog::Handle handle)
 {
-    auto msProduct = qobject_cast<MicrosoftStoreProduct *>(product);
-    if (msProduct) {
-        // Set product data
-        product->setTitle(productData["title"].toString());
-        product->setDescription(productData["description"].toString());
-        product->setPrice(productData["price"].toString());
-
-        // Validate product type matches store configuration
-        QString productKind = productData["productKind"].toString();
-        AbstractProduct::ProductType storeType;
-        if (productKind == "Durable") {
-            storeType = AbstractProduct::Unlockable;
-        } else if (productKind == "UnmanagedConsumable") {
-            storeType = AbstractProduct::Consumable;
-        } else {
-            qCritical() << "Unknown Microsoft Store product kind:" << productKind
-                        << "for product:" << product->identifier();
-            product->setStatus(AbstractProduct::Unknown);
-            return;
-        }
+    Q_UNUSED(handle)
+    return new MicrosoftStoreProduct();
+}
 
-        if (storeType != product->productType()) {
-            qCritical() << "Product type mismatch!" << product->identifier()
-                        << "Microsoft Store ID:" << productData["storeId"].toString() << "Expected:"
-                        << (product->productType() == AbstractProduct::Consumable   ? "Consumable"
-                            : product->productType() == AbstractProduct::Unlockable ? "Unlockable"
-                                                                                    : "None")
-                        << "Store reports:" << productKind;
-            product->setStatus(AbstractProduct::IncorrectProductType);
-            return;
-        }
+void MicrosoftStoreBackend::onProductQuerySucceeded(const QString &identifier, const QVariantMap &productData)
+{
+    const ProductCatalog::Handle handle = _catalog.handle(identifier);
+    if (handle < 0)
+        return;
 
-        // Track the product for later reference
-        _registeredProducts[product->identifier()] = product;
+    // Product data is applied together with the resulting status
+    ProductStoreData data;
+    data.title = productData["title"].toString();
+    data.description = productData["description"].toString();
+    data.price = productData["price"].toString();
+    data.currencyCode = productData["currencyCode"].toString(); // the Store reports no numeric price
+
+    // Validate product type matches store configuration
+    QString productKind = productData["productKind"].toString();
+    AbstractProduct::ProductType storeType;
+    if (productKind == "Durable") {
+        storeType = AbstractProduct::Unlockable;
+    } else if (productKind == "UnmanagedConsumable") {
+        storeType = AbstractProduct::Consumable;
+    } else {
+        qCCritical(lcStore) << "Unknown Microsoft Store product kind:" << productKind << "for product:" << identifier;
+        applyStoreData(handle, data, AbstractProduct::Unknown);
+        return;
+    }
 
-        product->setStatus(AbstractProduct::Registered);
-        emit productRegistered(product);
+    const AbstractProduct::ProductType productType = _catalog.productType(handle);
+    if (storeType != productType) {
+        qCCritical(lcStore) << "Product type mismatch!" << identifier
+                            << "Microsoft Store ID:" << productData["storeId"].toString() << "Expected:"
+                            << (productType == AbstractProduct::Consumable   ? "Consumable"
+                                : productType == AbstractProduct::Unlockable ? "Unlockable"
+                                                                             : "None")
+                            << "Store reports:" << productKind;
+        applyStoreData(handle, data, AbstractProduct::IncorrectProductType);
+        return;
+    }
 
-        qDebug() << "Product registered successfully:" << product->identifier();
+    const bool refresh = isRefreshing(handle);
+    applyStoreData(handle, data, AbstractProduct::Registered);
+    if (refresh) {
+        qCDebug(lcStore) << "Product refreshed:" << identifier;
+        return;
     }
+    if (AbstractProduct * product = _catalog.facade(handle))
+        emit productRegistered(product);
+
+    qCDebug(lcStore) << "Product registered successfully:" << identifier;
 }
 
-void MicrosoftStoreBackend::onProductQueryFailed(AbstractProduct * product, uint32_t hresult, const QString &message)
+void MicrosoftStoreBackend::onProductQueryFailed(const QString &identifier, uint32_t hresult, const QString &message)
 {
-    qWarning() << "Product query failed for:" << product->identifier() << "HRESULT:" << Qt::hex << Qt::showbase
-               << hresult << "Message:" << message;
-    product->setStatus(AbstractProduct::Unknown);
+    qCWarning(lcStore) << "Product query failed for:" << identifier << "HRESULT:" << Qt::hex << Qt::showbase << hresult
+                       << "Message:" << message;
+    const ProductCatalog::Handle handle = _catalog.handle(identifier);
+    if (handle >= 0)
+        setProductStatus(handle, AbstractProduct::Unknown);
 }
 
 void MicrosoftStoreBackend::onPurchaseComplete(AbstractProduct * product, StorePurchaseStatus status)
 {
-    qDebug() << "onPurchaseComplete: Backend thread:" << this->thread()
-             << "Current thread:" << QThread::currentThread();
+    qCDebug(lcStore) << "onPurchaseComplete: Backend thread:" << this->thread()
+                     << "Current thread:" << QThread::currentThread();
 
     if (!processingEnabled()) {
-        qDebug() << "Windows: onPurchaseComplete received but processing not enabled - queueing";
+        qCDebug(lcStore) << "Windows: onPurchaseComplete received but processing not enabled - queueing";
         _queuedPurchases.append({product, status});
         return;
     }
@@ -381,12 +458,12 @@ void MicrosoftStoreBackend::onPurchaseComplete(AbstractProduct * product, StoreP
 
 void MicrosoftStoreBackend::onRestoreSucceeded(const QList<QVariantMap> &restoredProducts)
 {
-    qDebug() << "onRestoreSucceeded: Backend thread:" << this->thread()
-             << "Current thread:" << QThread::currentThread();
-    qDebug() << "Restore succeeded, found" << restoredProducts.size() << "owned products";
+    qCDebug(lcStore) << "onRestoreSucceeded: Backend thread:" << this->thread()
+                     << "Current thread:" << QThread::currentThread();
+    qCDebug(lcStore) << "Restore succeeded, found" << restoredProducts.size() << "owned products";
 
     if (!processingEnabled()) {
-        qDebug() << "Windows: onRestoreComplete received but processing not enabled - queueing";
+        qCDebug(lcStore) << "Windows: onRestoreComplete received but processing not enabled - queueing";
         _queuedRestores = restoredProducts;
         return;
     }
@@ -396,8 +473,9 @@ void MicrosoftStoreBackend::onRestoreSucceeded(const QList<QVariantMap> &restore
 
 void MicrosoftStoreBackend::onRestoreFailed(uint32_t errorCode, const QString &message)
 {
-    qDebug() << "onRestoreFailed: Backend thread:" << this->thread() << "Current thread:" << QThread::currentThread();
-    qWarning() << "Restore failed with error code:" << Qt::hex << errorCode << "Message:" << message;
+    qCDebug(lcStore) << "onRestoreFailed: Backend thread:" << this->thread() << "Current thread:"
+                     << QThread::currentThread();
+    qCWarning(lcStore) << "Restore failed with error code:" << Qt::hex << errorCode << "Message:" << message;
 
     PurchaseError mappedError = mapHRESULTToPurchaseError(errorCode);
     emit restorePurchasesFailed(static_cast<int>(mappedError), errorCode, message);
@@ -405,29 +483,24 @@ void MicrosoftStoreBackend::onRestoreFailed(uint32_t errorCode, const QString &m
 
 void MicrosoftStoreBackend::onAllProductsQueried(const QList<QVariantMap> &products)
 {
-    qDebug() << "Store query completed, found" << products.size() << "products";
+    qCDebug(lcStore) << "Store query completed, found" << products.size() << "products";
     for (const auto &product : products) {
-        qDebug() << "Available product:" << product["productId"].toString() << "Title:" << product["title"].toString();
+        qCDebug(lcStore) << "Available product:" << product["productId"].toString() << "Title:"
+                         << product["title"].toString();
     }
-
-    // Now that products are available, restore existing purchases
-    qDebug() << "Products queried, now calling restorePurchases()";
-    restorePurchases();
 }
 
 void MicrosoftStoreBackend::onAllProductsQueryFailed(uint32_t hresult, const QString &message)
 {
-    qWarning() << "Failed to query all products - HRESULT:" << Qt::hex << Qt::showbase << hresult
-               << "Message:" << message;
+    qCWarning(lcStore) << "Failed to query all products - HRESULT:" << Qt::hex << Qt::showbase << hresult
+                       << "Message:" << message;
     // Continue anyway - this is just diagnostic info
-    // Still try to restore purchases even if we couldn't enumerate products
-    restorePurchases();
 }
 
 void MicrosoftStoreBackend::processQueuedTransactions()
 {
-    qDebug() << "Windows: Processing" << _queuedPurchases.size() << "queued purchases," << _queuedRestores.size()
-             << "queued restores";
+    qCDebug(lcStore) << "Windows: Processing" << _queuedPurchases.size() << "queued purchases,"
+                     << _queuedRestores.size() << "queued restores";
 
     // Process queued purchases
     for (const auto &queuedPurchase : _queuedPurchases)
@@ -465,12 +538,9 @@ void MicrosoftStoreBackend::processRestoredProducts(const QList<QVariantMap> &re
 
         // Find the Qt identifier by searching registered products
         QString qtIdentifier;
-        for (AbstractProduct * product : products()) {
-            if (product->microsoftStoreId() == msStoreId) {
-                qtIdentifier = product->identifier();
-                break;
-            }
-        }
+        const ProductCatalog::Handle handle = _catalog.findByMicrosoftStoreId(msStoreId);
+        if (handle >= 0)
+            qtIdentifier = _catalog.identifier(handle);
 
         if (!qtIdentifier.isEmpty()) {
             Transaction transaction;
@@ -478,9 +548,9 @@ void MicrosoftStoreBackend::processRestoredProducts(const QList<QVariantMap> &re
             transaction.productId = qtIdentifier;
             emit purchaseRestored(transaction);
             restoredCount++;
-            qDebug() << "Restored purchase: MS Store ID" << msStoreId << "-> Qt ID" << qtIdentifier;
+            qCDebug(lcStore) << "Restored purchase: MS Store ID" << msStoreId << "-> Qt ID" << qtIdentifier;
         } else {
-            qWarning() << "Could not find Qt product for Microsoft Store ID:" << msStoreId;
+            qCWarning(lcStore) << "Could not find Qt product for Microsoft Store ID:" << msStoreId;
         }
     }
 
@@ -491,7 +561,7 @@ void MicrosoftStoreBackend::initializeWindowHandle()
 {
     auto app = qobject_cast<QGuiApplication *>(QCoreApplication::instance());
     if (!app) {
-        qDebug() << "No QGuiApplication instance found";
+        qCDebug(lcStore) << "No QGuiApplication instance found";
         return;
     }
 
@@ -501,7 +571,7 @@ void MicrosoftStoreBackend::initializeWindowHandle()
         if (window) {
             // For QWindow, we just get the winId which creates the native window
             _hwnd = reinterpret_cast<HWND>(window->winId());
-            qDebug() << "Cached window handle:" << _hwnd;
+            qCDebug(lcStore) << "Cached window handle:" << _hwnd;
         }
     }
 }
@@ -509,7 +579,7 @@ void MicrosoftStoreBackend::initializeWindowHandle()
 void MicrosoftStoreBackend::queryAllProducts()
 {
     if (!_hwnd) {
-        qWarning() << "No window handle available for Store query";
+        qCWarning(lcStore) << "No window handle available for Store query";
         return;
     }
 
@@ -3,6 +3,7 @@
 
 #include <qt6purchasing/abstractstorebackend.h>
 #include <QTimer>
+#include <QStringList>
 #include <QVariantMap>
 #include <QMap>
 #include <windows.h>
@@ -13,29 +14,29 @@ class QThread;
 class MicrosoftStoreBackend : public AbstractStoreBackend
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(Store)
 
 public:
     explicit MicrosoftStoreBackend(QObject * parent = nullptr);
     ~MicrosoftStoreBackend();
 
     void startConnection() override;
-    void registerProduct(AbstractProduct * product) override;
+    void registerProduct(const QString &identifier) override;
     void purchaseProduct(AbstractProduct * product) override;
     void consumePurchase(Transaction transaction) override;
     bool canMakePurchases() const override;
 
-    // Transaction processing control
-    void enableProcessing() override;
-
     static MicrosoftStoreBackend * s_currentInstance;
 
 protected:
     void restorePurchasesImpl() override;
+    void processQueuedTransactions() override;
+    void finalizeBatch(const QList<Transaction> &transactions) override;
+    bool consumeQuantity(const QList<Transaction> &transactions) override;
+    AbstractProduct * createProduct(ProductCatalog::Handle handle) override;
 
 private slots:
-    void onProductQuerySucceeded(AbstractProduct * product, const QVariantMap &productData);
-    void onProductQueryFailed(AbstractProduct * product, uint32_t hresult, const QString &message);
+    void onProductQuerySucceeded(const QString &identifier, const QVariantMap &productData);
+    void onProductQueryFailed(const QString &identifier, uint32_t hresult, const QString &message);
     void onPurchaseComplete(AbstractProduct * product, winrt::Windows::Services::Store::StorePurchaseStatus status);
     void onRestoreSucceeded(const QList<QVariantMap> &restoredProducts);
     void onRestoreFailed(uint32_t errorCode, const QString &message);
@@ -49,9 +50,10 @@ private:
         winrt::Windows::Services::Store::StorePurchaseStatus status;
     };
 
-    void processQueuedTransactions();
     void processPurchase(AbstractProduct * product, winrt::Windows::Services::Store::StorePurchaseStatus status);
     void processRestoredProducts(const QList<QVariantMap> &restoredProducts);
+    bool prepareFulfillment(const Transaction &transaction, QString &storeId);
+    void fulfillConsumables(const QList<QList<Transaction>> &groups, const QStringList &storeIds);
     void initializeWindowHandle();
     void queryAllProducts();
     void trackWorkerThread(QThread * thread);
@@ -60,7 +62,6 @@ private:
     static PurchaseError mapHRESULTToPurchaseError(uint32_t hresult);
 
     HWND _hwnd = nullptr;
-    QMap<QString, AbstractProduct *> _registeredProducts; // Track products by identifier
 
     // Queued transaction data
     QList<QueuedPurchase> _queuedPurchases;
@@ -6,7 +6,6 @@
 class MicrosoftStoreProduct : public AbstractProduct
 {
     Q_OBJECT
-    QML_NAMED_ELEMENT(Product)
 
 public:
     explicit MicrosoftStoreProduct(QObject * parent = nullptr);
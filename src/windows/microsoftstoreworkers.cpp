@@ -1,4 +1,7 @@
 #include "microsoftstoreworkers.h"
+
+#include <qt6purchasing/storelogging.h>
+
 #include <QDebug>
 #include <QVariantMap>
 
@@ -35,7 +38,7 @@ void StoreProductQueryWorker::performQuery()
         if (!_productId.contains('.')) {
             // This might be a simple identifier, we should use microsoftStoreId if available
             // For now, we'll just use what we have
-            qDebug() << "Using product identifier as Store ID:" << _productId;
+            qCDebug(lcStore) << "Using product identifier as Store ID:" << _productId;
         }
 #endif
 
@@ -57,27 +60,30 @@ void StoreProductQueryWorker::performQuery()
                 productData["title"] = QString::fromWCharArray(storeProduct.Title().c_str());
                 productData["description"] = QString::fromWCharArray(storeProduct.Description().c_str());
                 productData["price"] = QString::fromWCharArray(storeProduct.Price().FormattedPrice().c_str());
+                productData["currencyCode"] = QString::fromWCharArray(storeProduct.Price().CurrencyCode().c_str());
                 productData["productKind"] = QString::fromWCharArray(storeProduct.ProductKind().c_str());
                 productData["isInUserCollection"] = storeProduct.IsInUserCollection();
 
                 emit querySucceeded(productData);
             } else {
-                qDebug() << "Product not found in store:" << _productId;
+                qCDebug(lcStore) << "Product not found in store:" << _productId;
                 emit queryFailed(0, "Product not found in store");
             }
         } else {
             uint32_t hresult = result.ExtendedError().value;
-            qWarning() << "Store query error for product" << _productId << "- HRESULT:" << Qt::hex << Qt::showbase
-                       << hresult;
+            qCWarning(lcStore) << "Store query error for product" << _productId << "- HRESULT:" << Qt::hex
+                               << Qt::showbase
+                               << hresult;
             emit queryFailed(hresult, QString("Store API error: 0x%1").arg(hresult, 0, 16));
         }
     } catch (const winrt::hresult_error &e) {
         uint32_t hresult = static_cast<uint32_t>(e.code().value);
         QString message = QString::fromWCharArray(e.message().c_str());
-        qWarning() << "Exception in product query:" << message << "HRESULT:" << Qt::hex << Qt::showbase << hresult;
+        qCWarning(lcStore) << "Exception in product query:" << message << "HRESULT:" << Qt::hex << Qt::showbase
+                           << hresult;
         emit queryFailed(hresult, message);
     } catch (...) {
-        qWarning() << "Unknown exception in product query";
+        qCWarning(lcStore) << "Unknown exception in product query";
         emit queryFailed(0x80004005, "Unknown exception");
     }
 
@@ -99,10 +105,10 @@ void StorePurchaseWorker::performPurchase()
 
         emit purchaseComplete(result.Status());
     } catch (const winrt::hresult_error &e) {
-        qWarning() << "Purchase HRESULT error:" << QString::fromWCharArray(e.message().c_str());
+        qCWarning(lcStore) << "Purchase HRESULT error:" << QString::fromWCharArray(e.message().c_str());
         emit purchaseComplete(StorePurchaseStatus::ServerError);
     } catch (...) {
-        qWarning() << "Unknown exception during purchase";
+        qCWarning(lcStore) << "Unknown exception during purchase";
         emit purchaseComplete(StorePurchaseStatus::ServerError);
     }
 
@@ -142,16 +148,16 @@ void StoreRestoreWorker::performRestore()
             emit restoreSucceeded(restoredProducts);
         } else {
             uint32_t hresult = result.ExtendedError().value;
-            qWarning() << "Windows Store restore error - HRESULT:" << Qt::hex << Qt::showbase << hresult;
+            qCWarning(lcStore) << "Windows Store restore error - HRESULT:" << Qt::hex << Qt::showbase << hresult;
             emit restoreFailed(hresult, QString("Windows Store API error: 0x%1").arg(hresult, 0, 16));
         }
     } catch (const winrt::hresult_error &e) {
         uint32_t errorCode = static_cast<uint32_t>(e.code().value);
         QString message = QString::fromWCharArray(e.message().c_str());
-        qWarning() << "Exception in restore:" << message << "Code:" << Qt::hex << errorCode;
+        qCWarning(lcStore) << "Exception in restore:" << message << "Code:" << Qt::hex << errorCode;
         emit restoreFailed(errorCode, message);
     } catch (...) {
-        qWarning() << "Unknown exception in restore";
+        qCWarning(lcStore) << "Unknown exception in restore";
         emit restoreFailed(0xFFFFFFFF, "Unknown exception during restore");
     }
 
@@ -186,25 +192,27 @@ void StoreAllProductsWorker::performQuery()
                 productData["title"] = QString::fromWCharArray(storeProduct.Title().c_str());
                 productData["description"] = QString::fromWCharArray(storeProduct.Description().c_str());
                 productData["price"] = QString::fromWCharArray(storeProduct.Price().FormattedPrice().c_str());
+                productData["currencyCode"] = QString::fromWCharArray(storeProduct.Price().CurrencyCode().c_str());
                 productData["productKind"] = QString::fromWCharArray(storeProduct.ProductKind().c_str());
 
                 products.append(productData);
             }
 
-            qDebug() << "Found" << products.size() << "associated products";
+            qCDebug(lcStore) << "Found" << products.size() << "associated products";
             emit querySucceeded(products);
         } else {
             uint32_t hresult = result.ExtendedError().value;
-            qWarning() << "Error querying all products - HRESULT:" << Qt::hex << Qt::showbase << hresult;
+            qCWarning(lcStore) << "Error querying all products - HRESULT:" << Qt::hex << Qt::showbase << hresult;
             emit queryFailed(hresult, QString("Store API error: 0x%1").arg(hresult, 0, 16));
         }
     } catch (const winrt::hresult_error &e) {
         uint32_t hresult = static_cast<uint32_t>(e.code().value);
         QString message = QString::fromWCharArray(e.message().c_str());
-        qWarning() << "Exception querying all products:" << message << "HRESULT:" << Qt::hex << Qt::showbase << hresult;
+        qCWarning(lcStore) << "Exception querying all products:" << message << "HRESULT:" << Qt::hex << Qt::showbase
+                           << hresult;
         emit queryFailed(hresult, message);
     } catch (...) {
-        qWarning() << "Unknown exception querying all products";
+        qCWarning(lcStore) << "Unknown exception querying all products";
         emit queryFailed(0x80004005, "Unknown exception");
     }
 
@@ -213,58 +221,79 @@ void StoreAllProductsWorker::performQuery()
 
 void StoreConsumableFulfillmentWorker::performFulfillment()
 {
+    StoreContext storeContext{nullptr};
     try {
         // Create StoreContext in worker thread
-        auto storeContext = StoreContext::GetDefault();
+        storeContext = StoreContext::GetDefault();
 
         // Initialize with window handle
         auto initWindow = storeContext.as<IInitializeWithWindow>();
         initWindow->Initialize(_hwnd);
-
-        // Generate unique tracking ID
-        winrt::guid trackingGuid = winrt::Windows::Foundation::GuidHelper::CreateNewGuid();
-
-        qDebug() << "Reporting consumable fulfillment for Store ID:" << _storeId << "Quantity:" << _quantity
-                 << "Tracking ID:" << QString::fromWCharArray(winrt::to_hstring(trackingGuid).c_str());
-
-        // Report fulfillment
-        auto result =
-            storeContext
-                .ReportConsumableFulfillmentAsync(winrt::hstring(_storeId.toStdWString()), _quantity, trackingGuid)
-                .get();
-
-        switch (result.Status()) {
-        case StoreConsumableStatus::Succeeded:
-            qDebug() << "Consumable fulfillment succeeded, balance:" << result.BalanceRemaining();
-            emit fulfillmentSucceeded();
-            break;
-        case StoreConsumableStatus::InsufficentQuantity:
-            qWarning() << "Consumable fulfillment failed: Insufficient quantity";
-            emit fulfillmentFailed(
-                static_cast<uint32_t>(StoreConsumableStatus::InsufficentQuantity), "Insufficient quantity"
-            );
-            break;
-        case StoreConsumableStatus::NetworkError:
-            qWarning() << "Consumable fulfillment failed: Network error";
-            emit fulfillmentFailed(static_cast<uint32_t>(StoreConsumableStatus::NetworkError), "Network error");
-            break;
-        case StoreConsumableStatus::ServerError:
-            qWarning() << "Consumable fulfillment failed: Server error";
-            emit fulfillmentFailed(static_cast<uint32_t>(StoreConsumableStatus::ServerError), "Server error");
-            break;
-        default:
-            qWarning() << "Consumable fulfillment failed: Unknown error";
-            emit fulfillmentFailed(0x80004005, "Unknown fulfillment status");
-        }
     } catch (const winrt::hresult_error &e) {
         uint32_t hresult = static_cast<uint32_t>(e.code().value);
         QString message = QString::fromWCharArray(e.message().c_str());
-        qWarning() << "Exception in consumable fulfillment:" << message << "HRESULT:" << Qt::hex << Qt::showbase
-                   << hresult;
-        emit fulfillmentFailed(hresult, message);
-    } catch (...) {
-        qWarning() << "Unknown exception in consumable fulfillment";
-        emit fulfillmentFailed(0x80004005, "Unknown exception");
+        qCWarning(lcStore) << "Exception creating StoreContext for fulfillment:" << message << "HRESULT:" << Qt::hex
+                           << Qt::showbase << hresult;
+        for (int index = 0; index < _storeIds.size(); ++index)
+            emit fulfillmentFailed(index, hresult, message);
+        emit finished();
+        return;
+    }
+
+    for (int index = 0; index < _storeIds.size(); ++index) {
+        const QString &storeId = _storeIds.at(index);
+        const uint32_t quantity = _quantities.at(index);
+        try {
+            // Generate unique tracking ID
+            winrt::guid trackingGuid = winrt::Windows::Foundation::GuidHelper::CreateNewGuid();
+
+            qCDebug(lcStore) << "Reporting consumable fulfillment for Store ID:" << storeId << "Quantity:" << quantity
+                             << "Tracking ID:" << QString::fromWCharArray(winrt::to_hstring(trackingGuid).c_str());
+
+            // Report fulfillment
+            auto result =
+                storeContext
+                    .ReportConsumableFulfillmentAsync(winrt::hstring(storeId.toStdWString()), quantity, trackingGuid)
+                    .get();
+
+            switch (result.Status()) {
+            case StoreConsumableStatus::Succeeded:
+                qCDebug(lcStore) << "Consumable fulfillment succeeded, balance:" << result.BalanceRemaining();
+                emit fulfillmentSucceeded(index);
+                break;
+            case StoreConsumableStatus::InsufficentQuantity:
+                qCWarning(lcStore) << "Consumable fulfillment failed: Insufficient quantity";
+                emit fulfillmentFailed(
+                    index, static_cast<uint32_t>(StoreConsumableStatus::InsufficentQuantity), "Insufficient quantity"
+                );
+                break;
+            case StoreConsumableStatus::NetworkError:
+                qCWarning(lcStore) << "Consumable fulfillment failed: Network error";
+                emit fulfillmentFailed(
+                    index, static_cast<uint32_t>(StoreConsumableStatus::NetworkError), "Network error"
+                );
+                break;
+            case StoreConsumableStatus::ServerError:
+                qCWarning(lcStore) << "Consumable fulfillment failed: Server error";
+                emit fulfillmentFailed(
+                    index, static_cast<uint32_t>(StoreConsumableStatus::ServerError), "Server error"
+                );
+                break;
+            default:
+                qCWarning(lcStore) << "Consumable fulfillment failed: Unknown error";
+                emit fulfillmentFailed(index, 0x80004005, "Unknown fulfillment status");
+            }
+        } catch (const winrt::hresult_error &e) {
+            uint32_t hresult = static_cast<uint32_t>(e.code().value);
+            QString message = QString::fromWCharArray(e.message().c_str());
+            qCWarning(lcStore) << "Exception in consumable fulfillment:" << message << "HRESULT:" << Qt::hex
+                               << Qt::showbase
+                               << hresult;
+            emit fulfillmentFailed(index, hresult, message);
+        } catch (...) {
+            qCWarning(lcStore) << "Unknown exception in consumable fulfillment";
+            emit fulfillmentFailed(index, 0x80004005, "Unknown exception");
+        }
     }
 
     emit finished();
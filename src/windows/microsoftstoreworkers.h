@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QVariantMap>
 #include <windows.h>
 #include <winrt/Windows.Services.Store.h>
@@ -90,28 +91,29 @@ signals:
     void finished();
 };
 
-// Worker for consumable fulfillment
+// Worker for consumable fulfillment; a batch shares one thread and StoreContext, and each
+// entry reports its own quantity
 class StoreConsumableFulfillmentWorker : public StoreWorker
 {
     Q_OBJECT
 public:
-    StoreConsumableFulfillmentWorker(const QString &storeId, uint32_t quantity, HWND hwnd) :
+    StoreConsumableFulfillmentWorker(const QStringList &storeIds, const QList<uint32_t> &quantities, HWND hwnd) :
         StoreWorker(hwnd, nullptr),
-        _storeId(storeId),
-        _quantity(quantity)
+        _storeIds(storeIds),
+        _quantities(quantities)
     {}
 
 public slots:
     void performFulfillment();
 
 signals:
-    void fulfillmentSucceeded();
-    void fulfillmentFailed(uint32_t errorCode, const QString &message);
+    void fulfillmentSucceeded(int index);
+    void fulfillmentFailed(int index, uint32_t errorCode, const QString &message);
     void finished();
 
 private:
-    QString _storeId;
-    uint32_t _quantity;
+    QStringList _storeIds;
+    QList<uint32_t> _quantities;
 };
 
 #endif // MICROSOFTSTOREWORKERS_H